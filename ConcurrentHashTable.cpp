@@ -0,0 +1,12 @@
+/*
+ConcurrentHashTable.cpp
+Thread-safe variant of the hash table: the same buckets, control bytes and RandomProbing walk,
+guarded by lock stripes over bucket regions (see ConcurrentHashTable.h).
+ */
+
+#include "ConcurrentHashTable.h"
+
+// CONCURRENTHASHTABLE TEMPLATE INSTANTIATION
+// The string -> int configuration is compiled once here;
+// ConcurrentHashTable.h marks it extern so other translation units reuse this code
+template class ConcurrentHashTable<string, int>;
@@ -0,0 +1,237 @@
+#ifndef CONCURRENTHASHTABLE_H
+#define CONCURRENTHASHTABLE_H
+
+#include <atomic>        // For the table pointer, sequence numbers, reader slots and stripe counters
+#include <memory>        // For std::unique_ptr (stripes, reader slots, retired tables)
+#include <mutex>         // For std::mutex (the retired table list)
+#include <shared_mutex>  // For std::shared_mutex (readers share a stripe, writers own it)
+
+#include "HashTable.h"   // Buckets, control bytes, hash and probe policies
+
+using namespace std;
+
+// Lock-free reads copy keys and values out of buckets that a writer may be changing at the same moment,
+// which is only well-defined when every key and value access is one lock-free atomic load or store
+namespace concurrent_detail {
+template<typename T, bool = is_trivially_copyable_v<T>>
+inline constexpr bool ATOMIC_FIELD = false;
+
+template<typename T>
+inline constexpr bool ATOMIC_FIELD<T, true> =
+    atomic_ref<T>::is_always_lock_free && alignof(T) >= atomic_ref<T>::required_alignment;
+} // namespace concurrent_detail
+
+// Integer, enum and pointer keys and values (no cached hash in the bucket) qualify; strings do not
+template<typename K, typename V>
+inline constexpr bool SUPPORTS_LOCK_FREE_READS =
+    concurrent_detail::ATOMIC_FIELD<K> && concurrent_detail::ATOMIC_FIELD<V> && !CACHES_HASH_BY_DEFAULT<K>;
+
+// ============================================================================
+// CONCURRENTHASHTABLE CLASS - THREAD-SAFE OPEN ADDRESSING WITH STRIPED LOCKS
+// ============================================================================
+/*
+The same design as BasicHashTable - control bytes, cached-hash buckets, Fibonacci home index and
+RandomProbing - made safe to share between threads:
+- Buckets are grouped into regions of RandomProbing::WINDOW buckets, the window a probe walk covers
+  before leaving its home. Region r is guarded by lock stripe r % STRIPES, so an operation locks one
+  stripe (shared for lookups, exclusive for changes) and runs in parallel with operations elsewhere
+- A walk that needs more than its home region (a full window) is redone with every stripe locked
+- Resizing is coordinated: the thread that finds its stripe over the load limit locks every stripe
+  in order, builds the new table and publishes it; operations that were waiting notice the new table
+  and retry. Each stripe counts its own entries and tombstones, so no shared counter is written on
+  the hot path
+- There is no operator[] and no reference into the table is ever returned (a resize would
+  invalidate it); update() runs a function on the stored value under the stripe lock instead
+
+LockFreeReads (on by default when SUPPORTS_LOCK_FREE_READS<K, V>): get() and contains() take no lock.
+Each stripe also has a sequence number that a writer makes odd while it changes the stripe's buckets;
+a reader notes it, walks the buckets with atomic loads and retries if the number changed meanwhile.
+A resize never changes the table readers are walking - it publishes a new one - so readers continue
+undisturbed. Readers announce themselves in per-thread-slot counters, not in one shared line; the old
+table is freed once every slot that was busy when it was replaced has been seen idle (checked by later
+writes, see reclaim()), and a resize waits for that when MAX_RETIRED tables are still pending.
+A tombstone cleanup rewrites the live table in place with every stripe's sequence number odd instead
+ */
+
+template<typename K = string,
+         typename V = int,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = equal_to<>,
+         typename Alloc = allocator<pair<const K, V>>,
+         bool LockFreeReads = SUPPORTS_LOCK_FREE_READS<K, V>>
+class ConcurrentHashTable {
+    static_assert(!LockFreeReads || SUPPORTS_LOCK_FREE_READS<K, V>,
+                  "lock-free reads need keys and values that are lock-free atomic (e.g. integers)");
+
+public:
+    // TYPE DEFINITIONS
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using Bucket = BasicHashTableBucket<K, V>;
+
+    static constexpr bool LOCK_FREE_READS = LockFreeReads;  // get()/contains() take no lock
+
+private:
+    static constexpr bool TRANSPARENT =
+        table_detail::IS_TRANSPARENT<Hash> && table_detail::IS_TRANSPARENT<KeyEqual>;
+
+    template<typename L>
+    using key_arg = typename table_detail::KeyArg<TRANSPARENT>::template type<L, K>;
+
+    using BucketAllocator = typename allocator_traits<Alloc>::template rebind_alloc<Bucket>;
+    using ControlAllocator = typename allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+
+    static constexpr size_t REGION = RandomProbing::WINDOW;  // Buckets per region (one probe window)
+    static constexpr size_t READER_SLOTS = 64;               // Counters that lock-free readers announce themselves in
+
+    // One generation of the table; a resize builds a new one and swaps the pointer
+    struct Storage {
+        vector<uint8_t, ControlAllocator> control;  // One state/tag byte per bucket (see bucket_detail)
+        vector<Bucket, BucketAllocator> buckets;    // Keys and values
+
+        Storage(size_t capacity, const Alloc& alloc)
+            : control(capacity, bucket_detail::ESS, ControlAllocator(alloc)), buckets(capacity, BucketAllocator(alloc)) {}
+        size_t capacity() const { return buckets.size(); }
+    };
+
+    // One lock stripe, on its own cache lines so that stripes never share a line
+    struct alignas(64) Stripe {
+        mutable shared_mutex lock;
+        atomic<size_t> sequence{0};    // Odd while a writer changes this stripe's buckets (lock-free reads)
+        atomic<size_t> items{0};       // Live entries in this stripe's regions
+        atomic<size_t> tombstones{0};  // EAR buckets in this stripe's regions
+    };
+
+    // Lock-free readers inside a table, per slot; threads are spread over the slots
+    struct alignas(64) ReaderSlot {
+        atomic<size_t> active{0};
+    };
+    static_assert(READER_SLOTS <= 64, "a retired table tracks its busy reader slots in one uint64_t");
+
+    // A replaced table and the reader slots that were busy when it was replaced
+    struct Retired {
+        unique_ptr<Storage> table;
+        uint64_t waiting;  // Bit i: slot i not yet seen idle since then
+    };
+
+    // How an operation holds its stripes
+    enum class Access {
+        READ,     // Shared: lookups
+        WRITE,    // Exclusive, changing buckets: the stripe's sequence number is odd meanwhile
+        REBUILD   // Exclusive, replacing the whole table: buckets readers may be walking stay untouched
+    };
+
+    // Outcome of an operation attempted under a lock
+    enum class Step {
+        DONE,      // Finished
+        ESCALATE,  // The probe walk left the home region: redo it with every stripe locked
+        GROW       // The stripe is over its load limit: resize, then retry
+    };
+
+    // Result of a probe walk limited to a number of buckets
+    struct Walk {
+        size_t index;    // The key's bucket if found, else the first free bucket (capacity if none)
+        bool found;      // The key is stored at index
+        bool complete;   // The walk reached the key, an ESS bucket or the end of the table
+    };
+
+    class LockGuard;  // One stripe or every stripe, locked for a scope
+
+    // PRIVATE MEMBER VARIABLES
+    atomic<Storage*> current;                   // The live table
+    vector<Retired> retired;                    // Replaced tables a lock-free reader may still be walking
+    mutex retireLock;                           // Guards retired
+    atomic<size_t> retiredCount;                // retired.size(), readable without retireLock
+    unique_ptr<Stripe[]> stripes;               // STRIPES locks, sequence numbers and counters
+    unique_ptr<ReaderSlot[]> readers;           // READER_SLOTS counters of lock-free readers
+    atomic<size_t> publishedCapacity;           // Capacity of the live table, readable without a lock
+    double maxLoad;                             // Per-stripe fill (entries plus tombstones) that triggers a resize
+    Alloc allocator;                            // Allocator for new tables
+    Hash hashPolicy;                            // Hash policy instance
+    KeyEqual keyEqual;                          // Key equality instance
+
+    // BUCKET ACCESS - atomic loads and stores when readers do not lock, plain ones otherwise
+    static uint8_t controlAt(const Storage& table, size_t index);
+    static void setControl(Storage& table, size_t index, uint8_t state);
+    static V valueAt(const Storage& table, size_t index);
+    static void storeValue(Storage& table, size_t index, V value);
+    static void storeEntry(Storage& table, size_t index, K key, V value, size_t hash);
+    static void clearEntry(Storage& table, size_t index);
+
+    // PRIVATE HELPER METHODS
+    template<typename KeyLike>
+    size_t hashFunction(const KeyLike& key) const;      // Full hash of a key
+    static size_t homeIndex(size_t hash, size_t capacity);  // Fibonacci reduction, as in BasicHashTable
+    static size_t regionSize(size_t capacity);          // Buckets in one region (the table if smaller)
+    static size_t readerSlot();                         // This thread's reader slot
+    Stripe& stripeOf(size_t index, size_t capacity) const;  // Stripe guarding a bucket
+    double stripeLimit(size_t capacity) const;          // Entries plus tombstones allowed per stripe
+    bool overLimit(const Stripe& stripe, size_t capacity) const;  // Stripe due for a resize
+    template<typename KeyLike>
+    Walk walk(const Storage& table, const KeyLike& key, size_t hash, size_t limit) const;  // Probe at most limit buckets
+    void place(Storage& table, size_t index, K key, V value, size_t hash);  // Fill a free bucket (its stripe is locked)
+    void lockStripe(Stripe& stripe, Access access) const;    // Lock one stripe
+    void unlockStripe(Stripe& stripe, Access access) const;  // Unlock one stripe
+    void lockAll(Access access) const;                  // Lock every stripe, in order
+    void unlockAll(Access access) const;                // Unlock every stripe
+    template<typename Op>
+    Step run(size_t hash, Access access, Op op) const;  // Lock the home stripe, run op, escalate if needed
+    template<typename KeyLike>
+    bool readOptimistic(const KeyLike& key, size_t hash, V* value) const;  // Lock-free lookup
+    void grow(size_t hash);                             // Coordinated resize if hash's stripe is still over
+    void rehash(size_t newCapacity);                    // Publish a rebuilt table (every stripe locked)
+    void cleanInPlace();                                // Drop tombstones without a new table (every stripe locked)
+    void retire(Storage* old);                          // Free a replaced table now or once its readers are gone
+    void reclaim(bool wait);                            // Free retired tables no reader can still be walking
+    size_t capacityFor(size_t count) const;             // Smallest capacity holding count within maxLoad
+
+public:
+    // PUBLIC CONSTANTS
+    static constexpr size_t STRIPES = 64;                   // Lock stripes (a power of two)
+    static constexpr size_t DEFAULT_INITIAL_CAPACITY = 8;   // Default table size
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.5;  // Default resize threshold
+    static constexpr double MAX_MAX_LOAD_FACTOR = 0.95;     // Highest threshold max_load_factor() accepts
+    static constexpr size_t MAX_RETIRED = 4;                // Replaced tables kept before a resize waits for readers
+
+    // CONSTRUCTOR AND DESTRUCTOR
+    // Create table with given capacity (rounded up to a power of two); not copyable or movable
+    explicit ConcurrentHashTable(size_t initCapacity = DEFAULT_INITIAL_CAPACITY, const Hash& hash = Hash(),
+                                 const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
+    ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+    ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+    ~ConcurrentHashTable();
+
+    // MAP OPERATIONS - all of them may be called from any number of threads at once
+    bool insert(K key, V value);                  // Insert key-value pair (no duplicates)
+    bool insert_or_assign(K key, V value);        // Insert, or overwrite the stored value; true if inserted
+    template<typename KeyArg = K, typename Fn>
+    bool update(const key_arg<KeyArg>& key, Fn fn);     // Call fn(V&) on the stored value under the lock
+    template<typename KeyArg = K>
+    bool remove(const key_arg<KeyArg>& key);      // Remove key-value pair
+    template<typename KeyArg = K>
+    bool contains(const key_arg<KeyArg>& key) const;    // Check if key exists
+    template<typename KeyArg = K>
+    optional<V> get(const key_arg<KeyArg>& key) const;  // Copy of the value for key
+
+    // UTILITY METHODS
+    // size() and alpha() add up the stripe counters without locking: exact once writers are done
+    vector<K> keys() const;       // Consistent snapshot of all keys (locks every stripe)
+    double alpha() const;         // Current load factor
+    size_t capacity() const;      // Total number of buckets
+    size_t size() const;          // Number of key-value pairs
+    double max_load_factor() const;     // Stripe fill that triggers a resize
+    void max_load_factor(double load);  // Set it, in (0, MAX_MAX_LOAD_FACTOR] (throws invalid_argument otherwise)
+    void reserve(size_t count);         // Size once so count evenly spread entries fit without a resize
+    size_t retiredTables() const;       // Replaced tables not yet freed (lock-free reads only; at most MAX_RETIRED)
+};
+
+// Template member definitions
+#include "ConcurrentHashTable.tpp"
+
+// The default configuration is compiled once, in ConcurrentHashTable.cpp
+extern template class ConcurrentHashTable<string, int>;
+
+#endif
@@ -0,0 +1,743 @@
+/* ConcurrentHashTable.tpp
+Template member definitions for ConcurrentHashTable, included at the bottom of ConcurrentHashTable.h.
+See ConcurrentHashTable.h for the locking scheme.
+ */
+
+#ifndef CONCURRENTHASHTABLE_TPP
+#define CONCURRENTHASHTABLE_TPP
+
+#include <thread>  // For std::this_thread::yield (lock-free readers waiting out a writer)
+
+// Shorthands for the template headers of out-of-line member definitions
+#define CHT_TEMPLATE template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, bool LockFreeReads>
+#define CHT_CLASS ConcurrentHashTable<K, V, Hash, KeyEqual, Alloc, LockFreeReads>
+
+/*
+Constructor - initializes the table with the specified capacity (rounded up to a power of two),
+every bucket ESS and every stripe unlocked with zero counts
+ */
+CHT_TEMPLATE
+CHT_CLASS::ConcurrentHashTable(size_t initCapacity, const Hash& hash, const KeyEqual& equal, const Alloc& alloc)
+    : current(nullptr), retiredCount(0), stripes(new Stripe[STRIPES]), readers(new ReaderSlot[READER_SLOTS]),
+      publishedCapacity(std::bit_ceil(initCapacity == 0 ? size_t(1) : initCapacity)),
+      maxLoad(DEFAULT_MAX_LOAD_FACTOR), allocator(alloc), hashPolicy(hash), keyEqual(equal) {
+    current.store(new Storage(publishedCapacity.load(), allocator));
+}
+
+//Destructor - no other thread may be using the table any more
+
+CHT_TEMPLATE
+CHT_CLASS::~ConcurrentHashTable() {
+    delete current.load();
+}
+
+// BUCKET ACCESS
+/*
+With lock-free reads a bucket can be read while a writer changes it. Every access to control bytes,
+keys and values then goes through atomic_ref (relaxed - the stripe sequence numbers order them), so
+a reader sees each field either old or new, never torn, and discards what it read if the sequence
+number moved. Otherwise these are the plain bucket operations
+ */
+CHT_TEMPLATE
+uint8_t CHT_CLASS::controlAt(const Storage& table, size_t index) {
+    if constexpr (LockFreeReads) {
+        return atomic_ref<uint8_t>(const_cast<uint8_t&>(table.control[index])).load(memory_order_relaxed);
+    } else {
+        return table.control[index];
+    }
+}
+
+CHT_TEMPLATE
+void CHT_CLASS::setControl(Storage& table, size_t index, uint8_t state) {
+    if constexpr (LockFreeReads) {
+        atomic_ref<uint8_t>(table.control[index]).store(state, memory_order_relaxed);
+    } else {
+        table.control[index] = state;
+    }
+}
+
+CHT_TEMPLATE
+V CHT_CLASS::valueAt(const Storage& table, size_t index) {
+    if constexpr (LockFreeReads) {
+        return atomic_ref<V>(const_cast<V&>(table.buckets[index].getValueRef())).load(memory_order_relaxed);
+    } else {
+        return table.buckets[index].getValue();
+    }
+}
+
+CHT_TEMPLATE
+void CHT_CLASS::storeValue(Storage& table, size_t index, V value) {
+    if constexpr (LockFreeReads) {
+        atomic_ref<V>(table.buckets[index].getValueRef()).store(value, memory_order_relaxed);
+    } else {
+        table.buckets[index].setValue(std::move(value));
+    }
+}
+
+CHT_TEMPLATE
+void CHT_CLASS::storeEntry(Storage& table, size_t index, K key, V value, size_t hash) {
+    Bucket& bucket = table.buckets[index];
+    if constexpr (LockFreeReads) {
+        atomic_ref<K>(const_cast<K&>(bucket.getKey())).store(key, memory_order_relaxed);
+        atomic_ref<V>(bucket.getValueRef()).store(value, memory_order_relaxed);
+    } else {
+        bucket.load(std::move(key), std::move(value), hash);
+    }
+}
+
+CHT_TEMPLATE
+void CHT_CLASS::clearEntry(Storage& table, size_t index) {
+    if constexpr (LockFreeReads) {
+        storeEntry(table, index, K(), V(), 0);
+    } else {
+        table.buckets[index].clear();
+    }
+}
+
+// LOCKING
+
+/*Holds one stripe, or every stripe when `stripe` is null, locked until the end of the scope
+ */
+CHT_TEMPLATE
+class CHT_CLASS::LockGuard {
+private:
+    const ConcurrentHashTable& table;
+    Stripe* stripe;
+    Access access;
+
+public:
+    LockGuard(const ConcurrentHashTable& table, Stripe* stripe, Access access)
+        : table(table), stripe(stripe), access(access) {
+        if (stripe) table.lockStripe(*stripe, access);
+        else table.lockAll(access);
+    }
+    ~LockGuard() {
+        if (stripe) table.unlockStripe(*stripe, access);
+        else table.unlockAll(access);
+    }
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator=(const LockGuard&) = delete;
+};
+
+/*Lock one stripe; a WRITE with lock-free readers also makes its sequence number odd
+(the release fence keeps the bucket stores that follow from becoming visible before it)
+ */
+CHT_TEMPLATE
+void CHT_CLASS::lockStripe(Stripe& stripe, Access access) const {
+    if (access == Access::READ) {
+        stripe.lock.lock_shared();
+        return;
+    }
+    stripe.lock.lock();
+    if constexpr (LockFreeReads) {
+        if (access == Access::WRITE) {
+            stripe.sequence.store(stripe.sequence.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+        }
+    }
+}
+
+//Unlock one stripe; a WRITE makes the sequence number even again, publishing the bucket stores
+
+CHT_TEMPLATE
+void CHT_CLASS::unlockStripe(Stripe& stripe, Access access) const {
+    if (access == Access::READ) {
+        stripe.lock.unlock_shared();
+        return;
+    }
+    if constexpr (LockFreeReads) {
+        if (access == Access::WRITE) {
+            stripe.sequence.store(stripe.sequence.load(memory_order_relaxed) + 1, memory_order_release);
+        }
+    }
+    stripe.lock.unlock();
+}
+
+/*Lock every stripe in index order - the only order in which anyone holds more than one,
+so whole-table operations cannot deadlock with each other or with single-stripe operations
+ */
+CHT_TEMPLATE
+void CHT_CLASS::lockAll(Access access) const {
+    for (size_t i = 0; i < STRIPES; i++) lockStripe(stripes[i], access);
+}
+
+CHT_TEMPLATE
+void CHT_CLASS::unlockAll(Access access) const {
+    for (size_t i = STRIPES; i-- > 0;) unlockStripe(stripes[i], access);
+}
+
+/*Run one operation on the key with this hash
+The stripe is chosen from the published capacity before locking; the table itself is only touched
+with the stripe held (a resize holds every stripe, so it cannot be replaced or freed meanwhile). If a
+resize changed the capacity in between, the wrong stripe is held and the attempt is retried.
+`op(table, limit)` walks at most `limit` buckets: the home region first, the whole table after ESCALATE
+@return: DONE, or GROW when the caller has to call grow() and retry
+ */
+CHT_TEMPLATE
+template<typename Op>
+typename CHT_CLASS::Step CHT_CLASS::run(size_t hash, Access access, Op op) const {
+    for (;;) {
+        size_t capacity = publishedCapacity.load(memory_order_acquire);
+        Step step;
+        {
+            LockGuard guard(*this, &stripeOf(homeIndex(hash, capacity), capacity), access);
+            Storage* table = current.load(memory_order_relaxed);
+            if (table->capacity() != capacity) continue;  // Resized before we got the lock
+            step = op(*table, regionSize(capacity));
+        }
+        if (step != Step::ESCALATE) return step;
+
+        LockGuard guard(*this, nullptr, access);
+        Storage* table = current.load(memory_order_relaxed);
+        return op(*table, table->capacity());
+    }
+}
+
+/*Lock-free lookup: walk the buckets without locking and keep the result only if no writer touched them
+The reader first announces itself in its slot, so the table it loads cannot be freed under it. It notes
+the sequence number of the stripe guarding its home region (or of every stripe, for a walk that leaves
+the region), waits out a writer that is mid-change, walks, and retries if any of those numbers moved or
+a resize published a new table. Readers never write anything another thread reads on its fast path
+@return: true if the key was found; its value is copied to *value when value is not null
+ */
+CHT_TEMPLATE
+template<typename KeyLike>
+bool CHT_CLASS::readOptimistic(const KeyLike& key, size_t hash, V* value) const {
+    ReaderSlot& slot = readers[readerSlot()];
+    slot.active.fetch_add(1, memory_order_seq_cst);
+
+    size_t sequences[STRIPES];
+    bool wholeTable = false;
+    bool found = false;
+    for (;;) {
+        const Storage* table = current.load(memory_order_seq_cst);
+        size_t capacity = table->capacity();
+        Stripe* home = wholeTable ? nullptr : &stripeOf(homeIndex(hash, capacity), capacity);
+        size_t first = home ? static_cast<size_t>(home - stripes.get()) : 0;
+        size_t count = home ? 1 : STRIPES;
+
+        bool busy = false;
+        for (size_t i = 0; i < count; i++) {
+            sequences[i] = stripes[first + i].sequence.load(memory_order_acquire);
+            busy = busy || (sequences[i] & 1);
+        }
+        if (busy) {
+            this_thread::yield();  // A writer is changing these buckets right now
+            continue;
+        }
+
+        Walk result = walk(*table, key, hash, home ? regionSize(capacity) : capacity);
+        V copy{};
+        if (result.found && value) copy = valueAt(*table, result.index);
+
+        atomic_thread_fence(memory_order_acquire);
+        bool unchanged = current.load(memory_order_relaxed) == table;
+        for (size_t i = 0; i < count && unchanged; i++) {
+            unchanged = stripes[first + i].sequence.load(memory_order_relaxed) == sequences[i];
+        }
+        if (!unchanged) continue;
+        if (!result.complete) {
+            wholeTable = true;  // The walk left the home region: check it against every stripe
+            continue;
+        }
+        found = result.found;
+        if (found && value) *value = copy;
+        break;
+    }
+
+    slot.active.fetch_sub(1, memory_order_release);
+    return found;
+}
+
+// PRIVATE HELPER METHODS
+
+//Full hash of a key (not yet reduced to an index)
+
+CHT_TEMPLATE
+template<typename KeyLike>
+size_t CHT_CLASS::hashFunction(const KeyLike& key) const {
+    return hashPolicy(key);
+}
+
+//Home bucket of a hash in a table of `capacity` buckets - the same Fibonacci hashing as BasicHashTable
+
+CHT_TEMPLATE
+size_t CHT_CLASS::homeIndex(size_t hash, size_t capacity) {
+    unsigned shift = capacity > 1 ? 64 - static_cast<unsigned>(std::countr_zero(capacity)) : 63;
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 11400714819323198485ull) >> shift) & (capacity - 1);
+}
+
+//Buckets in one region: a RandomProbing window, or the whole table when it is smaller than one
+
+CHT_TEMPLATE
+size_t CHT_CLASS::regionSize(size_t capacity) {
+    return std::min(capacity, REGION);
+}
+
+//This thread's reader slot: threads take slots round-robin, and threads sharing one simply add up
+
+CHT_TEMPLATE
+size_t CHT_CLASS::readerSlot() {
+    static atomic<size_t> nextSlot{0};
+    thread_local size_t slot = nextSlot.fetch_add(1, memory_order_relaxed) % READER_SLOTS;
+    return slot;
+}
+
+//The stripe guarding bucket `index`: regions are assigned to stripes round-robin
+
+CHT_TEMPLATE
+typename CHT_CLASS::Stripe& CHT_CLASS::stripeOf(size_t index, size_t capacity) const {
+    return stripes[(index / regionSize(capacity)) & (STRIPES - 1)];
+}
+
+/*Entries plus tombstones one stripe may hold: max_load_factor() of the buckets in its regions
+(a small table has fewer regions than stripes, and then each stripe in use guards one region)
+ */
+CHT_TEMPLATE
+double CHT_CLASS::stripeLimit(size_t capacity) const {
+    size_t stripesInUse = std::min(STRIPES, capacity / regionSize(capacity));
+    return maxLoad * static_cast<double>(capacity / stripesInUse);
+}
+
+/*Is this stripe's share of the table as full as max_load_factor() allows?
+Keys spread evenly over stripes, so each one holds its fraction of the load; checking only the
+stripe being written keeps the shared counters off the hot path
+ */
+CHT_TEMPLATE
+bool CHT_CLASS::overLimit(const Stripe& stripe, size_t capacity) const {
+    size_t used = stripe.items.load(memory_order_relaxed) + stripe.tombstones.load(memory_order_relaxed);
+    return static_cast<double>(used) >= stripeLimit(capacity);
+}
+
+/*Walk the key's RandomProbing sequence in `table` for at most `limit` buckets
+As in BasicHashTable::findInsertIndex, the walk stops at the key or at the first ESS bucket and
+remembers the first EAR bucket it passes. A region is exactly one probe window, so a walk limited
+to regionSize() never leaves the home region
+@return: the key's bucket, or the first free bucket, and whether the walk reached a conclusion
+ */
+CHT_TEMPLATE
+template<typename KeyLike>
+typename CHT_CLASS::Walk CHT_CLASS::walk(const Storage& table, const KeyLike& key, size_t hash, size_t limit) const {
+    size_t capacity = table.capacity();
+    RandomProbing::Sequence probe(homeIndex(hash, capacity), capacity - 1);
+    uint8_t tag = bucket_detail::tagOf(hash);
+    size_t firstFree = capacity;
+
+    for (size_t i = 0; i < limit; i++, probe.next()) {
+        size_t index = probe.index();
+        uint8_t state = controlAt(table, index);
+        if (state == bucket_detail::ESS) {
+            return {firstFree < capacity ? firstFree : index, false, true};
+        }
+        if (state == bucket_detail::EAR) {
+            if (firstFree == capacity) firstFree = index;
+        } else if (state == tag) {
+            const Bucket& bucket = table.buckets[index];
+            if constexpr (LockFreeReads) {
+                K stored = atomic_ref<K>(const_cast<K&>(bucket.getKey())).load(memory_order_relaxed);
+                if (keyEqual(stored, key)) return {index, true, true};
+            } else {
+                if constexpr (Bucket::CACHES_HASH) {
+                    if (bucket.getHash() != hash) continue;
+                }
+                if (keyEqual(bucket.getKey(), key)) return {index, true, true};
+            }
+        }
+    }
+    return {firstFree, false, limit >= capacity};
+}
+
+/*Fill free bucket `index` and count it in its stripe (the caller holds that stripe exclusively)
+The control byte is written last, so a lock-free reader never matches a half-written bucket
+ */
+CHT_TEMPLATE
+void CHT_CLASS::place(Storage& table, size_t index, K key, V value, size_t hash) {
+    Stripe& stripe = stripeOf(index, table.capacity());
+    if (controlAt(table, index) == bucket_detail::EAR) stripe.tombstones.fetch_sub(1, memory_order_relaxed);
+    storeEntry(table, index, std::move(key), std::move(value), hash);
+    setControl(table, index, bucket_detail::tagOf(hash));
+    stripe.items.fetch_add(1, memory_order_relaxed);
+}
+
+/*Coordinated resize, called after an insert found the home stripe of `hash` over its limit
+Every stripe is locked, so each waiting thread retries against the new table afterwards. If another
+thread resized first the stripe is no longer over and nothing happens. A stripe filled mostly by
+tombstones is cleaned in place at the same capacity, otherwise the capacity doubles
+ */
+CHT_TEMPLATE
+void CHT_CLASS::grow(size_t hash) {
+    LockGuard guard(*this, nullptr, Access::REBUILD);
+    size_t capacity = current.load(memory_order_relaxed)->capacity();
+    Stripe& stripe = stripeOf(homeIndex(hash, capacity), capacity);
+    if (!overLimit(stripe, capacity)) return;
+
+    bool mostlyTombstones = static_cast<double>(stripe.items.load(memory_order_relaxed)) < stripeLimit(capacity) / 2;
+    if (mostlyTombstones) cleanInPlace();
+    else rehash(capacity * 2);
+}
+
+/*Build a table of `newCapacity` buckets from the live one and publish it (every stripe is locked)
+Entries are placed by cached hash without comparing keys and the stripe counters are rebuilt for the
+new regions. With lock-free reads the old table is left exactly as it was - readers may still be
+walking it, and their results stay valid until they see the new pointer - and it goes to retire();
+otherwise its keys are moved out and it is freed right away
+ */
+CHT_TEMPLATE
+void CHT_CLASS::rehash(size_t newCapacity) {
+    Storage* old = current.load(memory_order_relaxed);
+    auto fresh = make_unique<Storage>(newCapacity, allocator);
+    for (size_t i = 0; i < STRIPES; i++) {
+        stripes[i].items.store(0, memory_order_relaxed);
+        stripes[i].tombstones.store(0, memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < old->capacity(); i++) {
+        if (!bucket_detail::isNormal(old->control[i])) continue;
+        size_t hash;
+        if constexpr (Bucket::CACHES_HASH) hash = old->buckets[i].getHash();
+        else hash = hashFunction(old->buckets[i].getKey());
+
+        RandomProbing::Sequence probe(homeIndex(hash, newCapacity), newCapacity - 1);
+        while (fresh->control[probe.index()] != bucket_detail::ESS) probe.next();
+        fresh->control[probe.index()] = bucket_detail::tagOf(hash);
+        if constexpr (LockFreeReads) {
+            fresh->buckets[probe.index()] = old->buckets[i];  // Copy: the old bucket must stay readable
+        } else {
+            fresh->buckets[probe.index()] = std::move(old->buckets[i]);
+        }
+        stripeOf(probe.index(), newCapacity).items.fetch_add(1, memory_order_relaxed);
+    }
+
+    current.store(fresh.release(), memory_order_seq_cst);
+    publishedCapacity.store(newCapacity, memory_order_release);
+
+    if constexpr (LockFreeReads) {
+        retire(old);
+    } else {
+        delete old;
+    }
+}
+
+/*Remove every tombstone by re-placing the live entries in the same arrays (every stripe is locked)
+Each stripe's sequence number is odd meanwhile, so a lock-free reader waits or discards what it read,
+exactly as around a single write. The entries are moved out first, every bucket is made ESS, and each
+entry goes back to the first ESS bucket of its walk - only the live entries are copied, never a table
+ */
+CHT_TEMPLATE
+void CHT_CLASS::cleanInPlace() {
+    Storage& table = *current.load(memory_order_relaxed);
+    if constexpr (LockFreeReads) {
+        for (size_t i = 0; i < STRIPES; i++) {
+            stripes[i].sequence.store(stripes[i].sequence.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_release);
+    }
+
+    vector<Bucket> live;
+    live.reserve(size());
+    for (size_t i = 0; i < table.capacity(); i++) {
+        if (bucket_detail::isNormal(controlAt(table, i))) live.push_back(std::move(table.buckets[i]));
+        setControl(table, i, bucket_detail::ESS);
+    }
+    for (size_t i = 0; i < STRIPES; i++) {
+        stripes[i].items.store(0, memory_order_relaxed);
+        stripes[i].tombstones.store(0, memory_order_relaxed);
+    }
+
+    for (Bucket& bucket : live) {
+        size_t hash;
+        if constexpr (Bucket::CACHES_HASH) hash = bucket.getHash();
+        else hash = hashFunction(bucket.getKey());
+
+        RandomProbing::Sequence probe(homeIndex(hash, table.capacity()), table.capacity() - 1);
+        while (controlAt(table, probe.index()) != bucket_detail::ESS) probe.next();
+        place(table, probe.index(), std::move(bucket.getKeyRef()), std::move(bucket.getValueRef()), hash);
+    }
+
+    if constexpr (LockFreeReads) {
+        for (size_t i = 0; i < STRIPES; i++) {
+            stripes[i].sequence.store(stripes[i].sequence.load(memory_order_relaxed) + 1, memory_order_release);
+        }
+    }
+}
+
+/*Hand a replaced table over for freeing once no lock-free reader can be walking it
+A reader in a slot that is idle now entered (or will enter) after the new pointer was stored and
+loads that one, so only the slots busy right now have to be seen idle later. With none busy the
+table is freed at once. When more than MAX_RETIRED tables are pending, this waits for readers to
+leave - every stripe is held, but lock-free readers never wait on a REBUILD lock, so they do leave
+ */
+CHT_TEMPLATE
+void CHT_CLASS::retire(Storage* old) {
+    uint64_t waiting = 0;
+    for (size_t i = 0; i < READER_SLOTS; i++) {
+        if (readers[i].active.load(memory_order_seq_cst) != 0) waiting |= uint64_t(1) << i;
+    }
+    if (waiting == 0) {
+        delete old;
+    } else {
+        lock_guard<mutex> guard(retireLock);
+        retired.push_back({unique_ptr<Storage>(old), waiting});
+        retiredCount.store(retired.size(), memory_order_relaxed);
+    }
+    while (retiredCount.load(memory_order_relaxed) > MAX_RETIRED) {
+        reclaim(true);
+        if (retiredCount.load(memory_order_relaxed) > MAX_RETIRED) this_thread::yield();
+    }
+}
+
+/*Free every retired table whose busy reader slots have all been seen idle since it was replaced
+Writers call this after each change; with `wait` false it returns at once when nothing is retired or
+another thread is already reclaiming, so the write path stays one relaxed load
+ */
+CHT_TEMPLATE
+void CHT_CLASS::reclaim(bool wait) {
+    if constexpr (LockFreeReads) {
+        if (!wait && retiredCount.load(memory_order_relaxed) == 0) return;
+        unique_lock<mutex> guard(retireLock, defer_lock);
+        if (wait) guard.lock();
+        else if (!guard.try_lock()) return;
+
+        for (Retired& entry : retired) {
+            for (uint64_t pending = entry.waiting; pending != 0; pending &= pending - 1) {
+                size_t slot = static_cast<size_t>(std::countr_zero(pending));
+                if (readers[slot].active.load(memory_order_seq_cst) == 0) entry.waiting &= ~(uint64_t(1) << slot);
+            }
+        }
+        std::erase_if(retired, [](const Retired& entry) { return entry.waiting == 0; });
+        retiredCount.store(retired.size(), memory_order_relaxed);
+    }
+}
+
+//Smallest power-of-two capacity holding `count` entries within max_load_factor()
+
+CHT_TEMPLATE
+size_t CHT_CLASS::capacityFor(size_t count) const {
+    double needed = std::ceil(static_cast<double>(count) / maxLoad);
+    return std::bit_ceil(std::max<size_t>(static_cast<size_t>(needed), 1));
+}
+
+// MAP OPERATIONS
+
+/*Insert a key-value pair
+@return: true if inserted successfully, false if key already exists
+ */
+CHT_TEMPLATE
+bool CHT_CLASS::insert(K key, V value) {
+    size_t hash = hashFunction(key);
+    bool inserted = false;
+    auto op = [&](Storage& table, size_t limit) {
+        size_t capacity = table.capacity();
+        if (overLimit(stripeOf(homeIndex(hash, capacity), capacity), capacity)) return Step::GROW;
+        Walk found = walk(table, key, hash, limit);
+        if (!found.complete) return Step::ESCALATE;
+        if (!found.found) {
+            place(table, found.index, std::move(key), std::move(value), hash);
+            inserted = true;
+        }
+        return Step::DONE;
+    };
+    while (run(hash, Access::WRITE, op) == Step::GROW) grow(hash);
+    reclaim(false);
+    return inserted;
+}
+
+/*Insert a key-value pair, or overwrite the value of a key already stored
+@return: true if the key was inserted, false if its value was assigned
+ */
+CHT_TEMPLATE
+bool CHT_CLASS::insert_or_assign(K key, V value) {
+    size_t hash = hashFunction(key);
+    bool inserted = false;
+    auto op = [&](Storage& table, size_t limit) {
+        size_t capacity = table.capacity();
+        if (overLimit(stripeOf(homeIndex(hash, capacity), capacity), capacity)) return Step::GROW;
+        Walk found = walk(table, key, hash, limit);
+        if (!found.complete) return Step::ESCALATE;
+        if (found.found) {
+            storeValue(table, found.index, std::move(value));
+        } else {
+            place(table, found.index, std::move(key), std::move(value), hash);
+            inserted = true;
+        }
+        return Step::DONE;
+    };
+    while (run(hash, Access::WRITE, op) == Step::GROW) grow(hash);
+    reclaim(false);
+    return inserted;
+}
+
+/*Read-modify-write of a stored value, e.g. update(key, [](int& count) { count++; })
+fn runs with the stripe locked, so it must be short and must not call back into the table
+(with lock-free reads it works on a copy that is stored back in one atomic write)
+@return: true if the key was found and fn was called
+ */
+CHT_TEMPLATE
+template<typename KeyArg, typename Fn>
+bool CHT_CLASS::update(const key_arg<KeyArg>& key, Fn fn) {
+    size_t hash = hashFunction(key);
+    bool updated = false;
+    run(hash, Access::WRITE, [&](Storage& table, size_t limit) {
+        Walk found = walk(table, key, hash, limit);
+        if (!found.complete) return Step::ESCALATE;
+        if (found.found) {
+            if constexpr (LockFreeReads) {
+                V value = valueAt(table, found.index);
+                fn(value);
+                storeValue(table, found.index, value);
+            } else {
+                fn(table.buckets[found.index].getValueRef());
+            }
+            updated = true;
+        }
+        return Step::DONE;
+    });
+    reclaim(false);
+    return updated;
+}
+
+/*Remove a key-value pair (its bucket becomes EAR, counted in its stripe)
+@return: true if removed successfully, false if key not found
+ */
+CHT_TEMPLATE
+template<typename KeyArg>
+bool CHT_CLASS::remove(const key_arg<KeyArg>& key) {
+    size_t hash = hashFunction(key);
+    bool removed = false;
+    run(hash, Access::WRITE, [&](Storage& table, size_t limit) {
+        Walk found = walk(table, key, hash, limit);
+        if (!found.complete) return Step::ESCALATE;
+        if (found.found) {
+            Stripe& stripe = stripeOf(found.index, table.capacity());
+            setControl(table, found.index, bucket_detail::EAR);
+            clearEntry(table, found.index);
+            stripe.items.fetch_sub(1, memory_order_relaxed);
+            stripe.tombstones.fetch_add(1, memory_order_relaxed);
+            removed = true;
+        }
+        return Step::DONE;
+    });
+    reclaim(false);
+    return removed;
+}
+
+//Check if a key exists (lock-free, or sharing its stripe with other readers)
+
+CHT_TEMPLATE
+template<typename KeyArg>
+bool CHT_CLASS::contains(const key_arg<KeyArg>& key) const {
+    size_t hash = hashFunction(key);
+    if constexpr (LockFreeReads) {
+        return readOptimistic(key, hash, nullptr);
+    } else {
+        bool found = false;
+        run(hash, Access::READ, [&](const Storage& table, size_t limit) {
+            Walk result = walk(table, key, hash, limit);
+            if (!result.complete) return Step::ESCALATE;
+            found = result.found;
+            return Step::DONE;
+        });
+        return found;
+    }
+}
+
+//Get a copy of the value for a key - a copy, so it stays valid after any resize
+
+CHT_TEMPLATE
+template<typename KeyArg>
+optional<V> CHT_CLASS::get(const key_arg<KeyArg>& key) const {
+    size_t hash = hashFunction(key);
+    if constexpr (LockFreeReads) {
+        V value{};
+        if (!readOptimistic(key, hash, &value)) return nullopt;
+        return value;
+    } else {
+        optional<V> value;
+        run(hash, Access::READ, [&](const Storage& table, size_t limit) {
+            Walk result = walk(table, key, hash, limit);
+            if (!result.complete) return Step::ESCALATE;
+            if (result.found) value = valueAt(table, result.index);
+            return Step::DONE;
+        });
+        return value;
+    }
+}
+
+// UTILITY METHODS
+
+//All keys at one instant: every stripe is locked (shared) while they are copied
+
+CHT_TEMPLATE
+vector<K> CHT_CLASS::keys() const {
+    LockGuard guard(*this, nullptr, Access::READ);
+    const Storage& table = *current.load(memory_order_relaxed);
+    vector<K> result;
+    for (size_t i = 0; i < table.capacity(); i++) {
+        if (bucket_detail::isNormal(table.control[i])) result.push_back(table.buckets[i].getKey());
+    }
+    return result;
+}
+
+//Current load factor: entries per bucket
+
+CHT_TEMPLATE
+double CHT_CLASS::alpha() const {
+    return static_cast<double>(size()) / static_cast<double>(capacity());
+}
+
+//Total number of buckets
+
+CHT_TEMPLATE
+size_t CHT_CLASS::capacity() const {
+    return publishedCapacity.load(memory_order_acquire);
+}
+
+//Number of entries: the sum of the stripe counters
+
+CHT_TEMPLATE
+size_t CHT_CLASS::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < STRIPES; i++) total += stripes[i].items.load(memory_order_relaxed);
+    return total;
+}
+
+//Get the per-stripe load at which the table resizes
+
+CHT_TEMPLATE
+double CHT_CLASS::max_load_factor() const {
+    LockGuard guard(*this, nullptr, Access::READ);
+    return maxLoad;
+}
+
+/*Set the resize threshold; later inserts grow the table if it is already above it
+@throws invalid_argument outside (0, MAX_MAX_LOAD_FACTOR]
+ */
+CHT_TEMPLATE
+void CHT_CLASS::max_load_factor(double load) {
+    if (!(load > 0.0 && load <= MAX_MAX_LOAD_FACTOR)) {
+        throw invalid_argument("max_load_factor must be in (0, 0.95]");
+    }
+    LockGuard guard(*this, nullptr, Access::REBUILD);
+    maxLoad = load;
+}
+
+//Grow once so that `count` entries fit without any further resize
+
+CHT_TEMPLATE
+void CHT_CLASS::reserve(size_t count) {
+    LockGuard guard(*this, nullptr, Access::REBUILD);
+    size_t target = capacityFor(count);
+    if (target > current.load(memory_order_relaxed)->capacity()) rehash(target);
+}
+
+//Replaced tables still waiting for lock-free readers to leave (0 without lock-free reads)
+
+CHT_TEMPLATE
+size_t CHT_CLASS::retiredTables() const {
+    return retiredCount.load(memory_order_relaxed);
+}
+
+#undef CHT_TEMPLATE
+#undef CHT_CLASS
+
+#endif
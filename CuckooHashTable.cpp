@@ -0,0 +1,12 @@
+/*
+CuckooHashTable.cpp
+Cuckoo variant of the hash table: two candidate buckets of 4 or 8 slots per key, bounded kick-out
+and a small stash (see CuckooHashTable.h).
+ */
+
+#include "CuckooHashTable.h"
+
+// CUCKOOHASHTABLE TEMPLATE INSTANTIATION
+// The string -> int configuration is compiled once here;
+// CuckooHashTable.h marks it extern so other translation units reuse this code
+template class CuckooHashTable<string, int>;
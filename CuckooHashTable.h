@@ -0,0 +1,235 @@
+#ifndef CUCKOOHASHTABLE_H
+#define CUCKOOHASHTABLE_H
+
+#include "HashTable.h"  // Buckets, control bytes, hash policies, DuplicatePolicy and prefetch
+
+using namespace std;
+
+namespace cuckoo_detail {
+/*
+SlotGroup - the control bytes of one cuckoo bucket (4 or 8 slots) packed into one integer,
+compared all at once with plain integer arithmetic (no SIMD needed for 8 bytes).
+Each query returns a mask with the high bit of byte i set when slot i qualifies
+ */
+template<size_t Slots>
+struct SlotGroup {
+    using Word = conditional_t<Slots == 8, uint64_t, uint32_t>;
+    static constexpr Word LOW_BITS = static_cast<Word>(0x7F7F7F7F7F7F7F7Full);   // 0x7F in every byte
+    static constexpr Word HIGH_BITS = static_cast<Word>(0x8080808080808080ull);  // 0x80 in every byte
+    static constexpr Word ONES = static_cast<Word>(0x0101010101010101ull);       // 0x01 in every byte
+
+    Word bytes;
+
+    // Byte i of the word is slot i's control byte, on any byte order
+    explicit SlotGroup(const uint8_t* p) : bytes(0) {
+        for (size_t i = 0; i < Slots; i++) bytes |= static_cast<Word>(p[i]) << (8 * i);
+    }
+
+    // Slots whose control byte equals tag: the zero bytes of bytes ^ tag, found without
+    // the carries of the usual (x - 1) & ~x trick so that no neighbour is reported by mistake
+    Word match(uint8_t tag) const {
+        Word x = bytes ^ (ONES * tag);
+        return ~(((x & LOW_BITS) + LOW_BITS) | x | LOW_BITS);
+    }
+
+    // Free slots: ESS is the only control byte with the high bit set (a cuckoo table has no tombstones)
+    Word matchFree() const { return bytes & HIGH_BITS; }
+
+    // Slot of the lowest bit of a mask, and the mask without it
+    static size_t lowestSlot(Word mask) { return static_cast<size_t>(std::countr_zero(mask)) / 8; }
+    static Word clearLowest(Word mask) { return mask & (mask - 1); }
+};
+} // namespace cuckoo_detail
+
+// ============================================================================
+// CUCKOOHASHTABLE CLASS - BUCKETIZED CUCKOO HASHING WITH A STASH
+// ============================================================================
+/*
+Every key has exactly two candidate buckets of SlotsPerBucket (4 or 8) slots each, so a lookup -
+hit or miss - reads two groups of control bytes and nothing else, however full the table is:
+- The first bucket is the Fibonacci home index of the key's hash, as in BasicHashTable. The second is
+  the first XOR an offset derived from the key's 7-bit tag (partial-key cuckoo hashing), so an entry
+  can be moved to its other bucket knowing only its current bucket and its control byte, without
+  hashing the key again
+- Both bucket indices come from the hash alone, so the two cache misses overlap instead of following
+  each other as the buckets of a probe walk do. A key is only read on a tag match
+- An insert takes a free slot in either bucket; when both are full it kicks a random entry of one of
+  them to that entry's other bucket, and so on, for at most MAX_KICKS moves. An entry still homeless
+  after that goes to a small stash that lookups check only while it is non-empty; a full stash grows
+  the table. remove() frees the slot (there are no tombstones) and pulls a stashed entry back in
+  when one fits. Keys that share both buckets beyond what doubling can separate (a weak hash) overflow
+  into the stash instead of growing the table without end
+capacity() counts slots. There is no incremental or parallel resizing: a resize moves every entry
+into the new table at once, kicking as an insert does
+ */
+
+template<typename K = string,
+         typename V = int,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = equal_to<>,
+         typename Alloc = allocator<pair<const K, V>>,
+         size_t SlotsPerBucket = 4>
+class CuckooHashTable {
+    static_assert(SlotsPerBucket == 4 || SlotsPerBucket == 8, "cuckoo buckets hold 4 or 8 slots");
+
+public:
+    // TYPE DEFINITIONS
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using Bucket = BasicHashTableBucket<K, V>;  // One slot
+
+private:
+    static constexpr bool TRANSPARENT =
+        table_detail::IS_TRANSPARENT<Hash> && table_detail::IS_TRANSPARENT<KeyEqual>;
+
+    template<typename L>
+    using key_arg = typename table_detail::KeyArg<TRANSPARENT>::template type<L, K>;
+
+    using BucketAllocator = typename allocator_traits<Alloc>::template rebind_alloc<Bucket>;
+    using ControlAllocator = typename allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+    using Group = cuckoo_detail::SlotGroup<SlotsPerBucket>;
+
+    // One generation of the table: SlotsPerBucket control bytes and slots per bucket
+    struct Storage {
+        vector<uint8_t, ControlAllocator> control;  // One state/tag byte per slot, a bucket's bytes side by side
+        vector<Bucket, BucketAllocator> slots;      // Keys and values, read only when a control byte matches
+        size_t mask = 0;                            // Number of buckets - 1 (a power of two, at least 2 buckets)
+        unsigned shift = 63;                        // 64 - log2(number of buckets), used by firstBucket()
+
+        explicit Storage(const Alloc& alloc) : control(ControlAllocator(alloc)), slots(BucketAllocator(alloc)) {}
+        size_t bucketCount() const { return mask + 1; }
+    };
+
+    // Where a key was found: a slot index, or an index into the stash
+    struct Position {
+        size_t index = SIZE_MAX;   // Slot (bucket * SlotsPerBucket + slot) or stash index, SIZE_MAX if absent
+        bool inStash = false;      // index is a stash index
+        bool found() const { return index != SIZE_MAX; }
+    };
+
+    // Entries moved along one insert's kick-out path before the last one is stashed
+    static constexpr size_t MAX_KICKS = 256;
+
+    // insert_bulk() prefetches both buckets of the entry this many places ahead
+    static constexpr size_t BULK_PREFETCH_DISTANCE = 16;
+
+    // get_many()/contains_many() hash and prefetch this many keys before resolving any of them
+    static constexpr size_t LOOKUP_BATCH = 32;
+
+    // PRIVATE MEMBER VARIABLES
+    Storage tableData;                  // The buckets
+    vector<Bucket, BucketAllocator> stash;  // Entries no kick-out path found room for (see collisionBound())
+    size_t numItems;                    // Number of key-value pairs, stash included
+    double maxLoad;                     // Resize when entries reach this fraction of the slots
+    size_t minBuckets;                  // Auto-shrink never goes below this (initial capacity or reserve())
+    uint64_t kickState;                 // xorshift state choosing the entries to kick out
+    Hash hashPolicy;                    // Hash policy instance
+    KeyEqual keyEqual;                  // Key equality instance
+
+    // PRIVATE HELPER METHODS
+    template<typename KeyLike>
+    size_t hashFunction(const KeyLike& key) const;           // Full hash of a key
+    size_t firstBucket(const Storage& table, size_t hash) const;           // Fibonacci home bucket
+    size_t otherBucket(const Storage& table, size_t bucket, uint8_t tag) const;  // The entry's other bucket
+    size_t bucketHash(const Bucket& bucket) const;           // Cached hash, or recomputed for compact slots
+    void allocateBuckets(size_t buckets);                    // Fresh empty slots, mask and shift
+    size_t bucketsFor(size_t count) const;                   // Smallest bucket count holding count within maxLoad
+    template<typename KeyLike>
+    size_t findInBucket(size_t bucket, size_t hash, const KeyLike& key) const;  // Slot holding key, or SIZE_MAX
+    template<typename KeyLike>
+    Position locate(const KeyLike& key, size_t hash) const;  // Both buckets, then the stash
+    bool tryPlace(Bucket& entry, uint8_t& tag, size_t bucket);  // Free slot or kick-out path; false leaves the homeless entry
+    void place(Bucket entry, size_t hash);                   // tryPlace, then the stash, then grow
+    void rehash(size_t buckets);                             // Move every entry into a table of `buckets` buckets
+    bool collisionBound() const;                             // Table too sparse for growing to help a full stash
+    void growIfNeeded();                                     // Double before an insert would pass maxLoad
+    void shrinkIfSparse();                                   // Auto-shrink after mass removal
+    void eraseAt(const Position& position);                  // Free a slot or drop a stash entry
+    void unstashInto(size_t bucket);                         // Move a stashed entry into bucket's free slot
+    template<typename KeyLike, typename Visit>
+    size_t lookupBatch(span<const KeyLike> keys, Visit visit) const;  // Hash, prefetch, then resolve each chunk
+    template<typename Entries>
+    size_t insertBulk(Entries& entries, bool moveEntries, DuplicatePolicy policy);  // Shared by both insert_bulk()s
+
+#ifdef HASHTABLE_STATS
+    mutable ProbeStats stats;                                // Buckets read per operation, for the benchmark
+    void recordProbes(size_t count) const;                   // Add one operation reading `count` buckets
+#endif
+
+public:
+    // PUBLIC CONSTANTS
+    static constexpr size_t SLOTS_PER_BUCKET = SlotsPerBucket;
+    static constexpr size_t STASH_CAPACITY = 8;              // Stashed entries before the table grows instead
+    static constexpr size_t DEFAULT_INITIAL_CAPACITY = 8;    // Default number of slots
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.9;   // Two choices of 4+ slots stay insertable well past 0.9
+    static constexpr double MAX_MAX_LOAD_FACTOR = 0.95;      // Highest threshold max_load_factor() accepts
+
+    // CONSTRUCTOR
+    // Create table with at least initCapacity slots (a power of two number of buckets, at least 2)
+    explicit CuckooHashTable(size_t initCapacity = DEFAULT_INITIAL_CAPACITY, const Hash& hash = Hash(),
+                             const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
+
+    // MAP OPERATIONS - the same as BasicHashTable's
+    bool insert(K key, V value);                  // Insert key-value pair (no duplicates), key is moved in
+    template<typename KeyArg = K>
+    bool emplace(const key_arg<KeyArg>& key, V value);  // Insert, building the stored key only if it is new
+    template<typename KeyArg = K>
+    bool remove(const key_arg<KeyArg>& key);      // Remove key-value pair
+    template<typename KeyArg = K>
+    bool contains(const key_arg<KeyArg>& key) const;    // Check if key exists (two buckets, then the stash)
+    template<typename KeyArg = K>
+    optional<V> get(const key_arg<KeyArg>& key) const;  // Get value for key
+    template<typename KeyArg = K>
+    V* find(const key_arg<KeyArg>& key);          // Pointer to the stored value, nullptr if missing
+    template<typename KeyArg = K>
+    const V* find(const key_arg<KeyArg>& key) const;    // Read-only pointer to the stored value
+    V& operator[](const K& key);                  // Array-style access (get/set)
+
+    // BATCHED LOOKUPS - both candidate buckets of every key in a batch are prefetched before any is compared
+    template<typename KeyArg = K>
+    size_t get_many(span<const key_arg<KeyArg>> keys, span<optional<V>> out) const;
+    template<typename KeyArg = K>
+    size_t contains_many(span<const key_arg<KeyArg>> keys, span<bool> out) const;
+
+    // UTILITY METHODS
+    vector<K> keys() const;       // Get all keys currently in table
+    template<typename Fn>
+    void for_each(Fn fn) const;   // Call fn(key, value) for every entry, slots first, then the stash
+    double alpha() const;         // Entries per slot
+    size_t capacity() const;      // Total number of slots
+    size_t size() const;          // Get number of key-value pairs
+    size_t stashSize() const;     // Entries in the stash (0 unless kick-out paths have failed)
+
+    // LOAD FACTOR AND SIZING
+    double max_load_factor() const;           // Load that triggers a resize
+    void max_load_factor(double load);        // Set it, in (0, MAX_MAX_LOAD_FACTOR] (throws invalid_argument otherwise)
+    void reserve(size_t count);               // Size once so count entries fit without any resize
+    void shrink_to_fit();                     // Smallest capacity holding size() entries within max_load_factor()
+
+    // BULK BUILDING - sized once for the batch; duplicates follow DuplicatePolicy as in BasicHashTable
+    size_t insert_bulk(span<const pair<K, V>> entries,
+                       DuplicatePolicy policy = DuplicatePolicy::FIRST_WINS);  // Copies the entries in
+    size_t insert_bulk(vector<pair<K, V>>&& entries,
+                       DuplicatePolicy policy = DuplicatePolicy::FIRST_WINS);  // Moves keys and values out of the vector
+
+#ifdef HASHTABLE_STATS
+    // BENCHMARK INSTRUMENTATION - a "probe" is one bucket read (a lookup reads one or two)
+    const ProbeStats& probeStats() const;  // Probe counters since construction or last reset
+    void resetProbeStats();                // Zero the probe counters
+#endif
+
+    // FRIEND FUNCTION FOR OUTPUT - Allows printing entire hash table
+    template<typename TK, typename TV, typename TH, typename TE, typename TA, size_t TS>
+    friend ostream& operator<<(ostream& os, const CuckooHashTable<TK, TV, TH, TE, TA, TS>& hashTable);
+};
+
+// Template member definitions
+#include "CuckooHashTable.tpp"
+
+// The default configuration is compiled once, in CuckooHashTable.cpp
+extern template class CuckooHashTable<string, int>;
+
+#endif
@@ -0,0 +1,685 @@
+/* CuckooHashTable.tpp
+Template member definitions for CuckooHashTable, included at the bottom of CuckooHashTable.h.
+See CuckooHashTable.h for the bucket layout and the insertion scheme.
+ */
+
+#ifndef CUCKOOHASHTABLE_TPP
+#define CUCKOOHASHTABLE_TPP
+
+// Probe counting compiles away unless HASHTABLE_STATS is defined
+#ifdef HASHTABLE_STATS
+#define CK_RECORD_PROBES(count) recordProbes(count)
+#else
+#define CK_RECORD_PROBES(count)
+#endif
+
+// Shorthands for the template headers of out-of-line member definitions
+#define CK_TEMPLATE template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, size_t SlotsPerBucket>
+#define CK_CLASS CuckooHashTable<K, V, Hash, KeyEqual, Alloc, SlotsPerBucket>
+
+/*
+Constructor - initializes the table with at least initCapacity slots
+The bucket count is a power of two and at least 2, so a key's two buckets are always different
+ */
+CK_TEMPLATE
+CK_CLASS::CuckooHashTable(size_t initCapacity, const Hash& hash, const KeyEqual& equal, const Alloc& alloc)
+    : tableData(alloc), stash(BucketAllocator(alloc)), numItems(0), maxLoad(DEFAULT_MAX_LOAD_FACTOR),
+      minBuckets(std::max<size_t>(2, std::bit_ceil((initCapacity + SlotsPerBucket - 1) / SlotsPerBucket))),
+      kickState(0x9E3779B97F4A7C15ull), hashPolicy(hash), keyEqual(equal) {
+    allocateBuckets(minBuckets);
+}
+
+// PRIVATE HELPER METHODS
+
+//Full hash of a key, not yet reduced to a bucket
+
+CK_TEMPLATE
+template<typename KeyLike>
+size_t CK_CLASS::hashFunction(const KeyLike& key) const {
+    return hashPolicy(key);
+}
+
+/*A key's first bucket: Fibonacci hashing of its full hash, as BasicHashTable picks a home bucket
+(the top bits of hash * 2^64 / golden ratio, independent of the low bits used for the tag)
+ */
+CK_TEMPLATE
+size_t CK_CLASS::firstBucket(const Storage& table, size_t hash) const {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 11400714819323198485ull) >> table.shift) & table.mask;
+}
+
+/*The other bucket of an entry in `bucket` whose control byte is `tag`
+XOR with an odd offset derived from the tag: applying it twice gives back the first bucket, so an
+entry's other bucket is known from where it is and its control byte alone, and the two always differ
+ */
+CK_TEMPLATE
+size_t CK_CLASS::otherBucket(const Storage& table, size_t bucket, uint8_t tag) const {
+    uint64_t offset = (static_cast<uint64_t>(tag) + 1) * 0xC6A4A7935BD1E995ull;
+    return (bucket ^ static_cast<size_t>(offset | 1)) & table.mask;
+}
+
+/*Full hash of the key stored in a slot
+Read from the slot when it caches hashes; compact slots (small trivially copyable keys) rehash the key
+ */
+CK_TEMPLATE
+size_t CK_CLASS::bucketHash(const Bucket& bucket) const {
+    if constexpr (Bucket::CACHES_HASH) {
+        return bucket.getHash();
+    } else {
+        return hashFunction(bucket.getKey());
+    }
+}
+
+//Replace tableData with `buckets` buckets (a power of two, at least 2) of empty slots, all ESS
+
+CK_TEMPLATE
+void CK_CLASS::allocateBuckets(size_t buckets) {
+    tableData.control.assign(buckets * SlotsPerBucket, bucket_detail::ESS);
+    tableData.slots.clear();
+    tableData.slots.resize(buckets * SlotsPerBucket);
+    tableData.mask = buckets - 1;
+    tableData.shift = 64 - static_cast<unsigned>(std::countr_zero(buckets));
+}
+
+//Smallest power-of-two bucket count whose slots hold `count` entries without reaching max_load_factor()
+
+CK_TEMPLATE
+size_t CK_CLASS::bucketsFor(size_t count) const {
+    size_t slots = static_cast<size_t>(std::ceil(static_cast<double>(count) / maxLoad));
+    return std::max<size_t>(2, std::bit_ceil((slots + SlotsPerBucket - 1) / SlotsPerBucket));
+}
+
+/*The slot of `bucket` holding this key, SIZE_MAX if none
+All of the bucket's control bytes are compared with the key's tag at once; the cached hash and then
+the key itself are only read for slots whose tag matches
+ */
+CK_TEMPLATE
+template<typename KeyLike>
+size_t CK_CLASS::findInBucket(size_t bucket, size_t hash, const KeyLike& key) const {
+    size_t first = bucket * SlotsPerBucket;
+    for (auto matches = Group(&tableData.control[first]).match(bucket_detail::tagOf(hash)); matches;
+         matches = Group::clearLowest(matches)) {
+        size_t slot = first + Group::lowestSlot(matches);
+        const Bucket& entry = tableData.slots[slot];
+        if constexpr (Bucket::CACHES_HASH) {
+            if (entry.getHash() != hash) continue;
+        }
+        if (keyEqual(entry.getKey(), key)) return slot;
+    }
+    return SIZE_MAX;
+}
+
+/*Find a key: its first bucket, its second bucket, then the stash if anything is stashed
+Both bucket indices come from the hash alone, so the CPU can load the second bucket's control bytes
+while it still compares the first: a miss waits about one memory latency for its two cache lines,
+not two in a row. (An explicit prefetch of the second bucket measured no faster.)
+ */
+CK_TEMPLATE
+template<typename KeyLike>
+typename CK_CLASS::Position CK_CLASS::locate(const KeyLike& key, size_t hash) const {
+    size_t first = firstBucket(tableData, hash);
+    size_t second = otherBucket(tableData, first, bucket_detail::tagOf(hash));
+
+    size_t slot = findInBucket(first, hash, key);
+    if (slot != SIZE_MAX) {
+        CK_RECORD_PROBES(1);
+        return {slot, false};
+    }
+    CK_RECORD_PROBES(2);
+    slot = findInBucket(second, hash, key);
+    if (slot != SIZE_MAX) return {slot, false};
+
+    for (size_t i = 0; i < stash.size(); i++) {
+        if constexpr (Bucket::CACHES_HASH) {
+            if (stash[i].getHash() != hash) continue;
+        }
+        if (keyEqual(stash[i].getKey(), key)) return {i, true};
+    }
+    return {};
+}
+
+/*Put `entry` (control byte `tag`, first candidate `bucket`) into the table
+Takes a free slot of either candidate bucket. When both are full, a random entry of one of them is
+swapped out for the carried one and carried on to its own other bucket, and so on for at most
+MAX_KICKS moves. Every entry but the carried one is in a slot of one of its two buckets throughout
+@return: true once everything has a slot; false leaves the entry still homeless in entry and tag
+ */
+CK_TEMPLATE
+bool CK_CLASS::tryPlace(Bucket& entry, uint8_t& tag, size_t bucket) {
+    auto fill = [&](size_t candidate) {
+        auto free = Group(&tableData.control[candidate * SlotsPerBucket]).matchFree();
+        if (!free) return false;
+        size_t slot = candidate * SlotsPerBucket + Group::lowestSlot(free);
+        tableData.control[slot] = tag;
+        tableData.slots[slot] = std::move(entry);
+        return true;
+    };
+    auto random = [&] {  // xorshift64
+        kickState ^= kickState << 13;
+        kickState ^= kickState >> 7;
+        kickState ^= kickState << 17;
+        return kickState;
+    };
+
+    size_t other = otherBucket(tableData, bucket, tag);
+    if (fill(bucket) || fill(other)) return true;
+
+    size_t current = (random() & 1) ? bucket : other;
+    for (size_t kick = 0; kick < MAX_KICKS; kick++) {
+        size_t slot = current * SlotsPerBucket + (random() & (SlotsPerBucket - 1));
+        std::swap(entry, tableData.slots[slot]);
+        std::swap(tag, tableData.control[slot]);
+        current = otherBucket(tableData, current, tag);  // The kicked-out entry's other bucket
+        if (fill(current)) {
+            CK_RECORD_PROBES(kick + 3);
+            return true;
+        }
+    }
+    CK_RECORD_PROBES(MAX_KICKS + 2);
+    return false;
+}
+
+/*Place a new entry: tryPlace(), then the stash for whatever entry the kick-out path left homeless,
+and when the stash is full too, double the table and try again (unless collisionBound())
+ */
+CK_TEMPLATE
+void CK_CLASS::place(Bucket entry, size_t hash) {
+    uint8_t tag = bucket_detail::tagOf(hash);
+    size_t bucket = firstBucket(tableData, hash);
+    while (!tryPlace(entry, tag, bucket)) {
+        if (stash.size() < STASH_CAPACITY || collisionBound()) {
+            stash.push_back(std::move(entry));
+            return;
+        }
+        rehash(tableData.bucketCount() * 2);
+        size_t homeless = bucketHash(entry);
+        tag = bucket_detail::tagOf(homeless);
+        bucket = firstBucket(tableData, homeless);
+    }
+}
+
+/*Move every entry, stash included, into a fresh table of `buckets` buckets
+Entries are moved (never copied) and placed like new ones, hashes taken from the slots when cached.
+If more than STASH_CAPACITY entries end up homeless the table doubles again (unless collisionBound())
+ */
+CK_TEMPLATE
+void CK_CLASS::rehash(size_t buckets) {
+    Storage previous = std::move(tableData);
+    auto previousStash = std::move(stash);
+    stash.clear();
+    tableData = Storage(Alloc(previous.slots.get_allocator()));
+    allocateBuckets(buckets);
+
+    auto move = [&](Bucket& slot) {
+        size_t hash = bucketHash(slot);
+        uint8_t tag = bucket_detail::tagOf(hash);
+        Bucket entry = std::move(slot);
+        if (!tryPlace(entry, tag, firstBucket(tableData, hash))) stash.push_back(std::move(entry));
+    };
+    for (size_t i = 0; i < previous.slots.size(); i++) {
+        if (bucket_detail::isNormal(previous.control[i])) move(previous.slots[i]);
+    }
+    for (Bucket& entry : previousStash) move(entry);
+
+    if (stash.size() > STASH_CAPACITY && !collisionBound()) rehash(buckets * 2);
+}
+
+/*Are failed kick-out paths down to the keys rather than the load?
+Below a quarter of max_load_factor() a full pair of buckets means many keys share both their buckets
+(a weak hash or adversarial keys), which no amount of doubling separates. The stash then takes the
+overflow beyond STASH_CAPACITY instead, and those keys cost a scan of it, as colliding keys cost a
+long probe walk in BasicHashTable
+ */
+CK_TEMPLATE
+bool CK_CLASS::collisionBound() const {
+    return static_cast<double>(numItems) * 4 < maxLoad * static_cast<double>(capacity());
+}
+
+//Double the table if one more entry would pass max_load_factor()
+
+CK_TEMPLATE
+void CK_CLASS::growIfNeeded() {
+    if (static_cast<double>(numItems + 1) > maxLoad * static_cast<double>(capacity())) {
+        rehash(tableData.bucketCount() * 2);
+    }
+}
+
+/* Auto-shrink - called after each remove, with the same rule as BasicHashTable: below an eighth of
+the resize threshold, move to the size that leaves the table a quarter to half as full as the
+threshold. Never shrinks below the initial or reserved capacity
+ */
+CK_TEMPLATE
+void CK_CLASS::shrinkIfSparse() {
+    if (tableData.bucketCount() <= minBuckets) return;
+    if (static_cast<double>(numItems) * 8 < maxLoad * static_cast<double>(capacity())) {
+        size_t target = std::max(minBuckets, bucketsFor(numItems * 2));
+        if (target < tableData.bucketCount()) rehash(target);
+    }
+}
+
+/*Take the entry at `position` out of the table
+A slot just becomes ESS again - nothing ever has to walk past it - and is offered to the stash
+ */
+CK_TEMPLATE
+void CK_CLASS::eraseAt(const Position& position) {
+    if (position.inStash) {
+        if (position.index + 1 != stash.size()) stash[position.index] = std::move(stash.back());
+        stash.pop_back();
+        return;
+    }
+    tableData.control[position.index] = bucket_detail::ESS;
+    tableData.slots[position.index].clear();
+    if (!stash.empty()) unstashInto(position.index / SlotsPerBucket);
+}
+
+//Move the first stashed entry that has `bucket` as one of its two buckets into bucket's free slot
+
+CK_TEMPLATE
+void CK_CLASS::unstashInto(size_t bucket) {
+    for (size_t i = 0; i < stash.size(); i++) {
+        size_t hash = bucketHash(stash[i]);
+        uint8_t tag = bucket_detail::tagOf(hash);
+        size_t first = firstBucket(tableData, hash);
+        if (first != bucket && otherBucket(tableData, first, tag) != bucket) continue;
+
+        auto free = Group(&tableData.control[bucket * SlotsPerBucket]).matchFree();
+        size_t slot = bucket * SlotsPerBucket + Group::lowestSlot(free);
+        tableData.control[slot] = tag;
+        tableData.slots[slot] = std::move(stash[i]);
+        eraseAt({i, true});
+        return;
+    }
+}
+
+// MAP OPERATIONS
+
+/*Insert a key-value pair
+A lookup of both buckets rejects duplicates, then the entry is placed (see tryPlace)
+@return: true if inserted successfully, false if key already exists
+ */
+CK_TEMPLATE
+bool CK_CLASS::insert(K key, V value) {
+    size_t hash = hashFunction(key);
+    if (locate(key, hash).found()) return false;
+
+    growIfNeeded();
+    place(Bucket(std::move(key), std::move(value), hash), hash);
+    numItems++;
+    return true;
+}
+
+/*Insert a key-value pair given only a view of the key (or any key_arg type)
+The stored key is built from it only once we know the key is new
+@return: true if inserted successfully, false if key already exists
+ */
+CK_TEMPLATE
+template<typename KeyArg>
+bool CK_CLASS::emplace(const key_arg<KeyArg>& key, V value) {
+    size_t hash = hashFunction(key);
+    if (locate(key, hash).found()) return false;
+
+    growIfNeeded();
+    place(Bucket(K(key), std::move(value), hash), hash);
+    numItems++;
+    return true;
+}
+
+/*Remove a key-value pair
+@return: true if removed successfully, false if key not found
+ */
+CK_TEMPLATE
+template<typename KeyArg>
+bool CK_CLASS::remove(const key_arg<KeyArg>& key) {
+    Position position = locate(key, hashFunction(key));
+    if (!position.found()) return false;
+
+    eraseAt(position);
+    numItems--;
+    shrinkIfSparse();
+    return true;
+}
+
+//Check if a key exists - reads the key's two buckets (and the stash, if it holds anything)
+
+CK_TEMPLATE
+template<typename KeyArg>
+bool CK_CLASS::contains(const key_arg<KeyArg>& key) const {
+    return locate(key, hashFunction(key)).found();
+}
+
+//Get the value associated with a key
+
+CK_TEMPLATE
+template<typename KeyArg>
+optional<V> CK_CLASS::get(const key_arg<KeyArg>& key) const {
+    Position position = locate(key, hashFunction(key));
+    if (!position.found()) return nullopt;
+    return (position.inStash ? stash[position.index] : tableData.slots[position.index]).getValue();
+}
+
+//Find the stored value for a key - nullptr if the key is not in the table
+
+CK_TEMPLATE
+template<typename KeyArg>
+V* CK_CLASS::find(const key_arg<KeyArg>& key) {
+    Position position = locate(key, hashFunction(key));
+    if (!position.found()) return nullptr;
+    return &(position.inStash ? stash[position.index] : tableData.slots[position.index]).getValueRef();
+}
+
+CK_TEMPLATE
+template<typename KeyArg>
+const V* CK_CLASS::find(const key_arg<KeyArg>& key) const {
+    Position position = locate(key, hashFunction(key));
+    if (!position.found()) return nullptr;
+    return &(position.inStash ? stash[position.index] : tableData.slots[position.index]).getValueRef();
+}
+
+/*Array-style access operator - inserts a default value for a new key
+A hit costs one lookup; a new key is looked up again after it is placed, since the kick-out path
+may have moved it on from the slot it first took
+ */
+CK_TEMPLATE
+V& CK_CLASS::operator[](const K& key) {
+    size_t hash = hashFunction(key);
+    Position position = locate(key, hash);
+    if (!position.found()) {
+        growIfNeeded();
+        place(Bucket(key, V(), hash), hash);
+        numItems++;
+        position = locate(key, hash);
+    }
+    return (position.inStash ? stash[position.index] : tableData.slots[position.index]).getValueRef();
+}
+
+// BATCHED LOOKUPS
+
+/*Resolve a batch of lookups LOOKUP_BATCH keys at a time, calling visit(i, position) for each key
+Every key of a chunk is hashed, then the control bytes of both its buckets and the slots of its first
+bucket (where most keys are) are prefetched, then the keys are looked up - by then a chunk's cache
+lines are loaded or on their way
+@return: number of keys found
+ */
+CK_TEMPLATE
+template<typename KeyLike, typename Visit>
+size_t CK_CLASS::lookupBatch(span<const KeyLike> keys, Visit visit) const {
+    size_t hashes[LOOKUP_BATCH];
+    size_t hits = 0;
+
+    for (size_t start = 0; start < keys.size(); start += LOOKUP_BATCH) {
+        size_t count = std::min(LOOKUP_BATCH, keys.size() - start);
+        for (size_t i = 0; i < count; i++) {
+            hashes[i] = hashFunction(keys[start + i]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t first = firstBucket(tableData, hashes[i]);
+            size_t second = otherBucket(tableData, first, bucket_detail::tagOf(hashes[i]));
+            probe_detail::prefetch(&tableData.control[first * SlotsPerBucket]);
+            probe_detail::prefetch(&tableData.control[second * SlotsPerBucket]);
+            probe_detail::prefetch(&tableData.slots[first * SlotsPerBucket]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            Position position = locate(keys[start + i], hashes[i]);
+            if (position.found()) hits++;
+            visit(start + i, position);
+        }
+    }
+    return hits;
+}
+
+/*Look up a batch of keys: out[i] = get(keys[i])
+@return: number of keys found
+ */
+CK_TEMPLATE
+template<typename KeyArg>
+size_t CK_CLASS::get_many(span<const key_arg<KeyArg>> keys, span<optional<V>> out) const {
+    if (out.size() < keys.size()) {
+        throw invalid_argument("get_many: out is shorter than keys");
+    }
+    return lookupBatch(keys, [&](size_t i, const Position& position) {
+        if (position.found()) {
+            out[i] = (position.inStash ? stash[position.index] : tableData.slots[position.index]).getValue();
+        } else {
+            out[i] = nullopt;
+        }
+    });
+}
+
+/*Check a batch of keys: out[i] = contains(keys[i])
+@return: number of keys found
+ */
+CK_TEMPLATE
+template<typename KeyArg>
+size_t CK_CLASS::contains_many(span<const key_arg<KeyArg>> keys, span<bool> out) const {
+    if (out.size() < keys.size()) {
+        throw invalid_argument("contains_many: out is shorter than keys");
+    }
+    return lookupBatch(keys, [&](size_t i, const Position& position) { out[i] = position.found(); });
+}
+
+// UTILITY METHODS
+
+//Get all keys currently stored in the table, stash included
+
+CK_TEMPLATE
+vector<K> CK_CLASS::keys() const {
+    vector<K> keyList;
+    keyList.reserve(numItems);
+    for_each([&](const K& key, const V&) { keyList.push_back(key); });
+    return keyList;
+}
+
+/*Visit every entry without copying any key: fn(const K&, const V&) is called once per entry
+(the table must not be changed from inside fn)
+ */
+CK_TEMPLATE
+template<typename Fn>
+void CK_CLASS::for_each(Fn fn) const {
+    for (size_t i = 0; i < tableData.slots.size(); i++) {
+        if (bucket_detail::isNormal(tableData.control[i])) {
+            fn(tableData.slots[i].getKey(), tableData.slots[i].getValue());
+        }
+    }
+    for (const Bucket& entry : stash) fn(entry.getKey(), entry.getValue());
+}
+
+//Current load factor: entries per slot
+
+CK_TEMPLATE
+double CK_CLASS::alpha() const {
+    return static_cast<double>(numItems) / static_cast<double>(capacity());
+}
+
+//Get total number of slots (buckets times SlotsPerBucket)
+
+CK_TEMPLATE
+size_t CK_CLASS::capacity() const {
+    return tableData.slots.size();
+}
+
+//Get number of key-value pairs currently stored in the table
+
+CK_TEMPLATE
+size_t CK_CLASS::size() const {
+    return numItems;
+}
+
+//Get number of stashed entries - lookups that miss both buckets only check the stash when this is not 0
+
+CK_TEMPLATE
+size_t CK_CLASS::stashSize() const {
+    return stash.size();
+}
+
+//Get the load (entries per slot) at which the table doubles
+
+CK_TEMPLATE
+double CK_CLASS::max_load_factor() const {
+    return maxLoad;
+}
+
+/*Set the resize threshold; grows the table right away if it is already above it
+Above about 0.95 (4 slots) kick-out paths grow long and fail, so the stash fills and the table
+doubles anyway
+ */
+CK_TEMPLATE
+void CK_CLASS::max_load_factor(double load) {
+    if (!(load > 0.0 && load <= MAX_MAX_LOAD_FACTOR)) {
+        throw invalid_argument("max_load_factor must be in (0, 0.95]");
+    }
+    maxLoad = load;
+    reserve(numItems);
+}
+
+/*Make room for `count` entries: after this, inserting up to count entries in total never resizes
+because of the load factor (a full stash still can). Never shrinks; the reserved capacity also
+becomes the floor for auto-shrinking
+ */
+CK_TEMPLATE
+void CK_CLASS::reserve(size_t count) {
+    size_t target = bucketsFor(count);
+    minBuckets = std::max(minBuckets, target);
+    if (target > tableData.bucketCount()) {
+        rehash(target);
+    }
+}
+
+/*Shrink to the smallest capacity that holds the current entries within max_load_factor()
+Also resets the auto-shrink floor to the new capacity
+ */
+CK_TEMPLATE
+void CK_CLASS::shrink_to_fit() {
+    size_t target = bucketsFor(numItems);
+    minBuckets = target;
+    if (target < tableData.bucketCount()) {
+        rehash(target);
+    }
+}
+
+// BULK BUILDING
+
+/*Insert a batch of entries - the shared body of both insert_bulk() overloads
+Every key is hashed first, the table is sized once for the whole batch, and each entry is then
+looked up and placed while the buckets of the entry BULK_PREFETCH_DISTANCE places ahead load.
+With THROW nothing is moved out of the batch, and the entries placed before the duplicate are taken
+out again before throwing, so the table holds exactly what it held before (its capacity may have grown)
+@return: number of new keys inserted
+ */
+CK_TEMPLATE
+template<typename Entries>
+size_t CK_CLASS::insertBulk(Entries& entries, bool moveEntries, DuplicatePolicy policy) {
+    size_t count = entries.size();
+    if (count == 0) return 0;
+
+    vector<size_t> hashes(count);
+    for (size_t i = 0; i < count; i++) {
+        hashes[i] = hashFunction(entries[i].first);
+    }
+
+    size_t target = bucketsFor(numItems + count);
+    if (target > tableData.bucketCount()) rehash(target);
+
+    // Kick-out paths move earlier entries, so an undo finds the batch's keys again by position in the batch
+    bool undoable = policy == DuplicatePolicy::THROW;
+    if (undoable) moveEntries = false;
+    vector<size_t> placed;
+    size_t inserted = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (i + BULK_PREFETCH_DISTANCE < count) {
+            size_t ahead = hashes[i + BULK_PREFETCH_DISTANCE];
+            size_t first = firstBucket(tableData, ahead);
+            probe_detail::prefetch(&tableData.control[first * SlotsPerBucket]);
+            probe_detail::prefetch(&tableData.control[otherBucket(tableData, first, bucket_detail::tagOf(ahead)) * SlotsPerBucket]);
+        }
+        auto& entry = entries[i];
+        Position position = locate(entry.first, hashes[i]);
+
+        if (position.found()) {
+            Bucket& stored = position.inStash ? stash[position.index] : tableData.slots[position.index];
+            if (policy == DuplicatePolicy::LAST_WINS) {
+                if (moveEntries) stored.setValue(std::move(entry.second));
+                else stored.setValue(entry.second);
+            } else if (undoable) {
+                for (size_t undo : placed) eraseAt(locate(entries[undo].first, hashes[undo]));
+                numItems -= inserted;
+                throw invalid_argument("insert_bulk: duplicate key");
+            }
+            continue;  // FIRST_WINS: keep the stored value
+        }
+
+        if (moveEntries) place(Bucket(std::move(entry.first), std::move(entry.second), hashes[i]), hashes[i]);
+        else place(Bucket(entry.first, entry.second, hashes[i]), hashes[i]);
+        if (undoable) placed.push_back(i);
+        numItems++;
+        inserted++;
+    }
+    return inserted;
+}
+
+/*Insert a batch of entries, copying them in (see insertBulk for how the batch is placed)
+@return: number of new keys inserted
+ */
+CK_TEMPLATE
+size_t CK_CLASS::insert_bulk(span<const pair<K, V>> entries, DuplicatePolicy policy) {
+    return insertBulk(entries, false, policy);
+}
+
+/*Insert a batch of entries, moving keys and values out of `entries`
+Their contents are unspecified afterwards, except with THROW, which copies so a failed call changes nothing
+@return: number of new keys inserted
+ */
+CK_TEMPLATE
+size_t CK_CLASS::insert_bulk(vector<pair<K, V>>&& entries, DuplicatePolicy policy) {
+    return insertBulk(entries, true, policy);
+}
+
+#ifdef HASHTABLE_STATS
+/*Record one operation that read `count` buckets
+Only compiled into the benchmark build
+ */
+CK_TEMPLATE
+void CK_CLASS::recordProbes(size_t count) const {
+    stats.walks++;
+    stats.probes += count;
+    if (count > stats.maxProbes) stats.maxProbes = count;
+}
+
+//Probe counters collected since construction or the last reset
+CK_TEMPLATE
+const ProbeStats& CK_CLASS::probeStats() const {
+    return stats;
+}
+
+//Zero the probe counters, e.g. between benchmark phases
+CK_TEMPLATE
+void CK_CLASS::resetProbeStats() {
+    stats = ProbeStats();
+}
+#endif
+
+/*Output operator for entire hash table - prints every occupied slot, then the stash
+ */
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, size_t SlotsPerBucket>
+ostream& operator<<(ostream& os, const CuckooHashTable<K, V, Hash, KeyEqual, Alloc, SlotsPerBucket>& hashTable) {
+    const auto& table = hashTable.tableData;
+    for (size_t i = 0; i < table.slots.size(); i++) {
+        if (bucket_detail::isNormal(table.control[i])) {
+            os << "Bucket " << i / SlotsPerBucket << " slot " << i % SlotsPerBucket << ": <"
+               << table.slots[i].getKey() << ", " << table.slots[i].getValue() << ">" << endl;
+        }
+    }
+    for (size_t i = 0; i < hashTable.stash.size(); i++) {
+        os << "Stash " << i << ": <" << hashTable.stash[i].getKey() << ", " << hashTable.stash[i].getValue()
+           << ">" << endl;
+    }
+    if (hashTable.numItems == 0) {
+        os << "Table is empty" << endl;
+    }
+    return os;
+}
+
+#undef CK_RECORD_PROBES
+#undef CK_TEMPLATE
+#undef CK_CLASS
+
+#endif
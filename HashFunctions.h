@@ -0,0 +1,326 @@
+#ifndef HASHFUNCTIONS_H
+#define HASHFUNCTIONS_H
+
+#include <cstddef>
+#include <cstdint>      // For fixed-width 64-bit arithmetic
+#include <cstring>      // For std::memcpy (unaligned reads)
+#include <functional>   // For std::hash (fallback for other key types)
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// SIMD support is chosen at compile time: AVX2 when the compiler targets it
+// (e.g. -march=native / HASHTABLE_NATIVE_ARCH), otherwise SSE2 on any x86-64 build
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HASHTABLE_HASH_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASHTABLE_HASH_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>     // For _umul128
+#endif
+
+using namespace std;
+
+// HASH POLICIES
+/*
+A hash policy is any default-constructible type with
+    size_t operator()(const K& key) const
+returning a full-width hash. BasicHashTable takes the policy as a template parameter,
+caches the full value in each bucket and reduces it to an index itself.
+The string policies below take string_view and declare is_transparent, so a table
+using them can be searched with string_view / const char* without building a string.
+ */
+
+// Low-level helpers shared by the hash policies
+namespace hash_detail {
+
+// Unaligned little-endian reads (memcpy compiles to a single load)
+inline uint64_t read64(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 64x64 -> 128-bit multiply: a receives the low half, b the high half
+inline void multiply128(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#else
+    uint64_t aHigh = a >> 32, aLow = static_cast<uint32_t>(a);
+    uint64_t bHigh = b >> 32, bLow = static_cast<uint32_t>(b);
+    uint64_t high = aHigh * bHigh, mid0 = aHigh * bLow, mid1 = bHigh * aLow, low = aLow * bLow;
+    uint64_t t = low + (mid0 << 32);
+    uint64_t carry = t < low;
+    uint64_t lo = t + (mid1 << 32);
+    carry += lo < t;
+    a = lo;
+    b = high + (mid0 >> 32) + (mid1 >> 32) + carry;
+#endif
+}
+
+// Multiply and fold the 128-bit product back to 64 bits
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply128(a, b);
+    return a ^ b;
+}
+
+// Constants: wyhash's default secret, and 16 splitmix64 words used by StripeHash
+constexpr uint64_t WY_SECRET[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+constexpr uint64_t STRIPE_SECRET[16] = {
+    0x2cb0f69f4abea221ull, 0x9417034723148989ull, 0xdd555950609dfe03ull, 0xdbafb150deb12800ull,
+    0x7e789b2e6c442cb6ull, 0xf41e5636c7e4f8c4ull, 0x0959d150f8fba7e4ull, 0xa97316f13cdb9eeaull,
+    0x74cd8258f9520068ull, 0x55c74a62e116868bull, 0xd2f4c799a2023cbdull, 0xdf98cb79a37b51b9ull,
+    0x396f5885524f3905ull, 0xaf1d56386ca3b276ull, 0xa9ffbe6b5104e85aull, 0x6bd0c51b9fd533b3ull};
+
+constexpr uint64_t STRIPE_PRIME32 = 0x9E3779B1ull;
+
+} // namespace hash_detail
+
+/*
+PolynomialHash - the table's original hash, kept for compatibility and comparison
+using Multiplicative String Hashing : it distributes strings uniformly across hash table buckets
+Handles string keys effectively by considering character order
+Since Prime number reduces pattern-based collisions and avoids arithmetic overflow issues
+- 31 = 2⁵ - 1: allows compiler optimization to (hash << 5)
+hash = (hash * multiplier) + char_code
+Processes one byte per step and clusters on short numeric keys, which is why it is no longer the default
+ */
+struct PolynomialHash {
+    using is_transparent = void;
+
+    size_t operator()(string_view key) const {
+        size_t hash = 0;  // Start with initial hash value of 0
+        for (char c : key) {
+            hash = hash * 31 + c;
+        }
+        return hash;
+    }
+};
+
+/*
+WyHash - the default hash, following Wang Yi's wyhash (final version)
+Keys up to 16 bytes are read with two or four overlapping loads, longer keys are consumed
+16 bytes per step (48 bytes per step, in three independent lanes, past 48 bytes),
+and every step is one 64x64 -> 128-bit multiply
+ */
+struct WyHash {
+    using is_transparent = void;
+    uint64_t seed = 0;
+
+    bool operator==(const WyHash&) const = default;  // Same seed: every key hashes the same
+
+    size_t operator()(string_view key) const {
+        using namespace hash_detail;
+        const char* p = key.data();
+        size_t len = key.size();
+        uint64_t s = seed ^ mix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+        uint64_t a, b;
+
+        if (len <= 16) {
+            if (len >= 4) {
+                size_t middle = (len >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + middle);
+                b = (read32(p + len - 4) << 32) | read32(p + len - 4 - middle);
+            } else if (len > 0) {
+                a = (static_cast<uint64_t>(static_cast<unsigned char>(p[0])) << 16) |
+                    (static_cast<uint64_t>(static_cast<unsigned char>(p[len >> 1])) << 8) |
+                    static_cast<unsigned char>(p[len - 1]);
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t remaining = len;
+            if (remaining > 48) {
+                uint64_t lane1 = s, lane2 = s;
+                do {
+                    s = mix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ s);
+                    lane1 = mix(read64(p + 16) ^ WY_SECRET[2], read64(p + 24) ^ lane1);
+                    lane2 = mix(read64(p + 32) ^ WY_SECRET[3], read64(p + 40) ^ lane2);
+                    p += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                s ^= lane1 ^ lane2;
+            }
+            while (remaining > 16) {
+                s = mix(read64(p) ^ WY_SECRET[1], read64(p + 8) ^ s);
+                p += 16;
+                remaining -= 16;
+            }
+            a = read64(p + remaining - 16);
+            b = read64(p + remaining - 8);
+        }
+
+        a ^= WY_SECRET[1];
+        b ^= s;
+        multiply128(a, b);
+        return static_cast<size_t>(mix(a ^ WY_SECRET[0] ^ len, b ^ WY_SECRET[1]));
+    }
+};
+
+/*
+StripeHash - XXH3-style hash for long keys (not bit-compatible with xxHash)
+Keys up to 128 bytes go through the WyHash core. Longer keys are consumed in 64-byte stripes
+by eight 64-bit accumulator lanes: each lane adds a neighbour's input word plus the product of
+the low and high halves of its own (input ^ secret) word, and every 16 stripes the lanes are
+scrambled. With AVX2 that is 32 bytes per instruction, with SSE2 16 bytes; the scalar fallback
+computes exactly the same values, so hashes never depend on the instruction set.
+ */
+struct StripeHash {
+    using is_transparent = void;
+
+    size_t operator()(string_view key) const {
+        if (key.size() <= 128) {
+            return WyHash()(key);
+        }
+        using namespace hash_detail;
+        size_t len = key.size();
+        alignas(32) uint64_t acc[8];
+        for (size_t i = 0; i < 8; i++) acc[i] = STRIPE_SECRET[i] ^ len;
+        accumulateStripes(acc, key.data(), len);
+
+        uint64_t result = len * 0x9E3779B185EBCA87ull;
+        for (size_t i = 0; i < 4; i++) {
+            result += mix(acc[2 * i] ^ STRIPE_SECRET[8 + 2 * i], acc[2 * i + 1] ^ STRIPE_SECRET[9 + 2 * i]);
+        }
+        // Final avalanche
+        result ^= result >> 37;
+        result *= 0x165667919E3779F9ull;
+        result ^= result >> 32;
+        return static_cast<size_t>(result);
+    }
+
+private:
+    /*
+    Per stripe:   acc[j] += input[j ^ 1] + lo32(input[j] ^ secret[j]) * hi32(input[j] ^ secret[j])
+    Every 16th:   acc[j] = (acc[j] ^ (acc[j] >> 47) ^ secret[8 + j]) * PRIME32
+    All full stripes are processed in order, then the last 64 bytes (overlapping the previous
+    stripe when len is not a multiple of 64). The SIMD versions keep the lanes in registers.
+     */
+    static void accumulateStripes(uint64_t* acc, const char* p, size_t len) {
+        using namespace hash_detail;
+        size_t stripes = (len - 1) / 64;
+#if defined(HASHTABLE_HASH_AVX2)
+        const __m256i* secret = reinterpret_cast<const __m256i*>(STRIPE_SECRET);
+        const __m256i prime = _mm256_set1_epi32(static_cast<int>(STRIPE_PRIME32));
+        __m256i lanes[2] = {_mm256_load_si256(reinterpret_cast<const __m256i*>(acc)),
+                            _mm256_load_si256(reinterpret_cast<const __m256i*>(acc) + 1)};
+        auto accumulate = [&](const char* stripe) {
+            for (size_t i = 0; i < 2; i++) {
+                __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe) + i);
+                __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256(secret + i));
+                __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+            }
+        };
+        auto scramble = [&]() {
+            for (size_t i = 0; i < 2; i++) {
+                __m256i value = lanes[i];
+                value = _mm256_xor_si256(_mm256_xor_si256(value, _mm256_srli_epi64(value, 47)),
+                                         _mm256_loadu_si256(secret + 2 + i));
+                __m256i low = _mm256_mul_epu32(value, prime);
+                __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+                lanes[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+            }
+        };
+#elif defined(HASHTABLE_HASH_SSE2)
+        const __m128i* secret = reinterpret_cast<const __m128i*>(STRIPE_SECRET);
+        const __m128i prime = _mm_set1_epi32(static_cast<int>(STRIPE_PRIME32));
+        __m128i lanes[4];
+        for (size_t i = 0; i < 4; i++) lanes[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(acc) + i);
+        auto accumulate = [&](const char* stripe) {
+            for (size_t i = 0; i < 4; i++) {
+                __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + i);
+                __m128i keyed = _mm_xor_si128(data, _mm_loadu_si128(secret + i));
+                __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+                __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+            }
+        };
+        auto scramble = [&]() {
+            for (size_t i = 0; i < 4; i++) {
+                __m128i value = lanes[i];
+                value = _mm_xor_si128(_mm_xor_si128(value, _mm_srli_epi64(value, 47)), _mm_loadu_si128(secret + 4 + i));
+                __m128i low = _mm_mul_epu32(value, prime);
+                __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+                lanes[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+            }
+        };
+#else
+        uint64_t* lanes = acc;
+        auto accumulate = [&](const char* stripe) {
+            for (size_t j = 0; j < 8; j++) {
+                uint64_t keyed = read64(stripe + 8 * j) ^ STRIPE_SECRET[j];
+                lanes[j] += read64(stripe + 8 * (j ^ 1)) + (keyed & 0xFFFFFFFFull) * (keyed >> 32);
+            }
+        };
+        auto scramble = [&]() {
+            for (size_t j = 0; j < 8; j++) {
+                uint64_t value = lanes[j];
+                lanes[j] = ((value ^ (value >> 47)) ^ STRIPE_SECRET[8 + j]) * STRIPE_PRIME32;
+            }
+        };
+#endif
+        for (size_t stripe = 0; stripe < stripes; stripe++) {
+            accumulate(p + stripe * 64);
+            if ((stripe & 15) == 15) scramble();
+        }
+        accumulate(p + len - 64);
+
+#if defined(HASHTABLE_HASH_AVX2)
+        for (size_t i = 0; i < 2; i++) _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + i, lanes[i]);
+#elif defined(HASHTABLE_HASH_SSE2)
+        for (size_t i = 0; i < 4; i++) _mm_store_si128(reinterpret_cast<__m128i*>(acc) + i, lanes[i]);
+#endif
+    }
+};
+
+/*
+DefaultHash<K> - the hash BasicHashTable uses unless another policy is named
+Strings use WyHash; integers, enums and pointers go through one 64x64 -> 128-bit multiply
+(std::hash is the identity for them, which would put consecutive ids in consecutive buckets);
+any other type uses std::hash followed by the same mixing step
+ */
+template<typename K, typename = void>
+struct DefaultHash {
+    size_t operator()(const K& key) const {
+        using namespace hash_detail;
+        return static_cast<size_t>(mix(static_cast<uint64_t>(std::hash<K>{}(key)) ^ WY_SECRET[0], WY_SECRET[1]));
+    }
+};
+
+template<typename K>
+struct DefaultHash<K, enable_if_t<is_integral_v<K> || is_enum_v<K> || is_pointer_v<K>>> {
+    size_t operator()(K key) const {
+        using namespace hash_detail;
+        uint64_t bits;
+        if constexpr (is_pointer_v<K>) bits = reinterpret_cast<uintptr_t>(key);
+        else bits = static_cast<uint64_t>(key);
+        return static_cast<size_t>(mix(bits ^ WY_SECRET[0], WY_SECRET[1]));
+    }
+};
+
+template<>
+struct DefaultHash<string> : WyHash {};
+
+template<>
+struct DefaultHash<string_view> : WyHash {};
+
+#endif
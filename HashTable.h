@@ -2,100 +2,508 @@
 #define HASHTABLE_H
 
 #include <string>
+#include <string_view>  // For allocation-free key lookups
 #include <vector>       // For std::vector to store the hash table buckets
 #include <optional>     // For std::optional for methods that might not return a value
+#include <span>         // For std::span (bulk insertion)
+#include <ranges>       // For std::ranges::begin / end (from_range)
+#include <stdexcept>    // For std::invalid_argument
+#include <cmath>        // For std::ceil
 #include <iostream>
+#include <algorithm>    // For std::max / std::fill
+#include <atomic>       // For std::atomic_ref (claiming buckets during a parallel rehash)
+#include <thread>       // For std::thread (parallel rehash workers)
+#include <bit>          // For std::bit_ceil / std::countr_zero (power-of-two capacities)
+#include <cstdint>      // For uint64_t / SIZE_MAX
+#include <cstring>      // For std::memcpy (inline string keys)
+#include <functional>   // For std::equal_to
+#include <memory>       // For std::allocator / std::allocator_traits
+#include <type_traits>  // For compile-time bucket layout selection
+#include <utility>      // For std::swap / std::move
+
+#include "HashFunctions.h"  // Hash policies: PolynomialHash, WyHash, StripeHash, DefaultHash
+#include "ProbePolicies.h"  // Probe policies: RandomProbing, LinearProbing, TriangularProbing, GroupProbing
+#include "HugePageAllocator.h"  // HugePageAllocator: huge-page backed, cache-line aligned bucket storage
 
 using namespace std;
 
 // BUCKET STATE DEFINITIONS
 /*
-Enum to represent the three possible states of each bucket in the hash table:
-NORMAL: Bucket contains a valid key-value pair
-ESS: Empty Since Start - bucket has never been used (helps stop probing)
-EAR: Empty After Remove - bucket had data that was removed (can be reused)
+Each bucket's state lives in its own control byte, in a dense array kept apart from the keys and
+values, so a probe reads one byte per bucket and only touches key storage when that byte could match:
+NORMAL: 0x00-0x7F - bucket holds a key; the byte is a 7-bit tag taken from the key's hash
+                    (with RobinHoodProbing: the entry's distance from its home bucket and a 3-bit tag)
+ESS:    0x80      - Empty Since Start, bucket has never been used (helps stop probing)
+EAR:    0xFE      - Empty After Remove, bucket had data that was removed (can be reused)
+0xFF marks padding past the last bucket, so group probing can always load a whole group of bytes
+ */
+namespace bucket_detail {
+inline constexpr uint8_t ESS = 0x80;
+inline constexpr uint8_t EAR = 0xFE;
+inline constexpr uint8_t SENTINEL = 0xFF;
+
+inline bool isNormal(uint8_t control) { return (control & 0x80) == 0; }
+inline bool isEmpty(uint8_t control) { return (control & 0x80) != 0; }
+
+// Tag stored in a NORMAL bucket's control byte - low hash bits, independent of the home index
+inline uint8_t tagOf(size_t hash) { return static_cast<uint8_t>(hash & 0x7F); }
+
+// Storage for the cached hash - empty (and optimized away) when the bucket does not cache it
+template<bool Cached>
+struct HashField {
+    size_t hash = 0;
+    size_t getStoredHash() const { return hash; }
+    void setStoredHash(size_t newHash) { hash = newHash; }
+};
+
+template<>
+struct HashField<false> {
+    size_t getStoredHash() const { return 0; }
+    void setStoredHash(size_t) {}
+};
+
+/*
+InlineKey - how a table with string keys stores a key: 24 bytes inside the bucket and no heap
+allocation of its own. Keys of up to INLINE_CAPACITY bytes are kept in the bucket itself; a longer key
+is appended to the table's key arena (one contiguous char array) and the bucket keeps its offset and
+length. Reading a key needs the arena's data pointer, so the table, not the bucket, turns it into a
+string_view
+ */
+class InlineKey {
+public:
+    static constexpr size_t INLINE_CAPACITY = 23;  // Longest key kept in the bucket
+
+    InlineKey() : bytes{}, length(0) {}
+
+    // Store key, appending it to arena (a vector<char>) when it does not fit in the bucket
+    template<typename Arena>
+    void assign(string_view key, Arena& arena) {
+        if (key.size() <= INLINE_CAPACITY) {
+            std::memcpy(bytes, key.data(), key.size());
+            length = static_cast<uint8_t>(key.size());
+            return;
+        }
+        uint64_t offset = arena.size();
+        uint64_t size = key.size();
+        arena.insert(arena.end(), key.begin(), key.end());
+        std::memcpy(bytes, &offset, sizeof(offset));
+        std::memcpy(bytes + sizeof(offset), &size, sizeof(size));
+        length = LONG;
+    }
+
+    // The key's characters; arena is the data of the arena the key was assigned with
+    string_view view(const char* arena) const {
+        if (length != LONG) return string_view(bytes, length);
+        return string_view(arena + field(0), field(sizeof(uint64_t)));
+    }
+
+    // Arena bytes this key occupies (0 for a key kept in the bucket)
+    size_t arenaBytes() const { return length == LONG ? field(sizeof(uint64_t)) : 0; }
+
+    // Copy a long key from arena to the end of target and point at the copy (arena compaction)
+    template<typename Arena>
+    void moveTo(const char* arena, Arena& target) {
+        if (length == LONG) assign(view(arena), target);
+    }
+
+private:
+    static constexpr uint8_t LONG = 0xFF;  // length value of a key stored in the arena
+
+    uint64_t field(size_t at) const {
+        uint64_t value;
+        std::memcpy(&value, bytes + at, sizeof(value));
+        return value;
+    }
+
+    char bytes[INLINE_CAPACITY];  // The key, or its arena offset and length
+    uint8_t length;               // Key length, or LONG
+};
+} // namespace bucket_detail
+
+/*
+Small trivially copyable keys (integers, ids, small PODs) are cheap to hash again and to compare,
+so their buckets drop the cached hash: a uint64_t -> int bucket is 16 bytes instead of 24
  */
-enum class BucketType { NORMAL, ESS, EAR };
+template<typename K>
+inline constexpr bool CACHES_HASH_BY_DEFAULT = !(is_trivially_copyable_v<K> && sizeof(K) <= 16);
 
-// HASHTABLEBUCKET CLASS - REPRESENTS A SINGLE SLOT IN THE HASH TABLE
+// HASHTABLEBUCKET CLASS - THE KEY/VALUE STORAGE OF A SINGLE SLOT IN THE HASH TABLE
+// (whether the slot is in use is recorded in the table's control bytes, not here)
 
-class HashTableBucket {
+template<typename K, typename V, bool CacheHash = CACHES_HASH_BY_DEFAULT<K>>
+class BasicHashTableBucket : private bucket_detail::HashField<CacheHash> {
 private:
-    string key;      // The key stored in this bucket
-    int value;       // The value associated with the key
-    BucketType type; // Current state of this bucket (NORMAL, ESS, or EAR)
+    K key;           // The key stored in this bucket
+    V value;         // The value associated with the key
 
 public:
+    // Whether the full hash of the key is stored in the bucket (chosen at compile time)
+    static constexpr bool CACHES_HASH = CacheHash;
+
     // CONSTRUCTORS
-    HashTableBucket();                          // Default constructor - creates empty bucket
-    HashTableBucket(string key, int value);     // Constructor with key-value pair
+    BasicHashTableBucket();                                  // Default constructor - empty key and value
+    BasicHashTableBucket(K key, V value, size_t hash = 0);   // Constructor with key-value pair (key is moved in)
 
     // BUCKET OPERATIONS
-    void load(string key, int value);           // Load key-value pair and mark as NORMAL
-    void clear();                               // Clear bucket and mark as EAR
-
-    // STATE CHECKING METHODS
-    bool isEmpty() const;                       // Check if bucket is empty (ESS or EAR)
-    bool isEmptySinceStart() const;             // Check if bucket has never been used (ESS)
-    bool isEmptyAfterRemove() const;            // Check if bucket was cleared (EAR)
-    bool isNormal() const;                      // Check if bucket has valid data (NORMAL)
+    void load(K key, V value, size_t hash);     // Move key-value pair in
+    void clear();                               // Reset key and value, releasing what they own
 
     // GETTER METHODS
-    string getKey() const;                      // Get the key stored in this bucket
-    int getValue() const;                       // Get the value stored in this bucket
-    BucketType getType() const;                 // Get the current bucket type
+    const K& getKey() const;                    // Get the key stored in this bucket (no copy)
+    const V& getValue() const;                  // Get the value stored in this bucket
+    size_t getHash() const;                     // Get the cached full hash of the key (0 if not cached)
 
     // SETTER METHOD
-    void setValue(int newValue);                // Update the value in this bucket
+    void setValue(V newValue);                  // Update the value in this bucket
 
     // REFERENCE ACCESSOR - Needed for operator[] to return modifiable reference
-    int& getValueRef() {
+    V& getValueRef() {
         return value;  // Return direct reference to the value for modification
     }
+    const V& getValueRef() const {
+        return value;
+    }
+
+    // KEY REFERENCE - lets the table move an inline key's arena bytes when it compacts its key arena
+    K& getKeyRef() {
+        return key;
+    }
 
     // FRIEND FUNCTION FOR OUTPUT - Allows printing bucket contents
-    friend ostream& operator<<(ostream& os, const HashTableBucket& bucket);
+    template<typename BK, typename BV, bool BC>
+    friend ostream& operator<<(ostream& os, const BasicHashTableBucket<BK, BV, BC>& bucket);
+};
+
+// A string -> int bucket (HashTable itself keeps its keys as InlineKeys: see BasicHashTable::Bucket)
+using HashTableBucket = BasicHashTableBucket<string, int>;
+
+// PROBE STATISTICS - Counters filled in only when HASHTABLE_STATS is defined
+// (the benchmark target defines it; normal builds pay nothing for them)
+struct ProbeStats {
+    size_t walks = 0;      // Number of probe walks (one per insert/lookup/remove)
+    size_t probes = 0;     // Total buckets inspected across all walks
+    size_t maxProbes = 0;  // Longest single walk seen
+};
+
+// Heterogeneous lookup support: key_arg<L> is L itself when the hash and equality are
+// transparent (e.g. string keys looked up by string_view / const char*), otherwise K
+namespace table_detail {
+template<bool Transparent>
+struct KeyArg {
+    template<typename L, typename K>
+    using type = L;
+};
+
+template<>
+struct KeyArg<false> {
+    template<typename L, typename K>
+    using type = K;
+};
+
+template<typename T, typename = void>
+inline constexpr bool IS_TRANSPARENT = false;
+
+template<typename T>
+inline constexpr bool IS_TRANSPARENT<T, void_t<typename T::is_transparent>> = true;
+} // namespace table_detail
+
+// What a bulk insert does with a key that is already in the table (or earlier in the same batch)
+enum class DuplicatePolicy {
+    FIRST_WINS,  // Keep the value already stored, skip the new one (like insert())
+    LAST_WINS,   // Overwrite the stored value with the new one
+    THROW        // Treat it as an error: throw invalid_argument and leave the table's contents unchanged
 };
 
 // ============================================================================
 // HASHTABLE CLASS - MAIN HASH TABLE IMPLEMENTATION USING OPEN ADDRESSING
 // ============================================================================
+/*
+K, V:      key and value types (both default-constructible and movable)
+Hash:      hash policy mapping a key to a full-width hash (see HashFunctions.h)
+KeyEqual:  key equality; lookups by other types (string_view, const char*) are allowed
+           when both Hash and KeyEqual declare is_transparent
+Alloc:     allocator, rebound to the bucket, control byte and key arena types
+           (HugePageAllocator maps large arrays on transparent huge pages, see HugePageAllocator.h)
+Probe:     probing engine: RandomProbing, LinearProbing, TriangularProbing, GroupProbing or
+           RobinHoodProbing (ProbePolicies.h)
+HashTable below is the default configuration: string keys, int values, WyHash, random probing.
+ */
+
+template<typename K = string,
+         typename V = int,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = equal_to<>,
+         typename Alloc = allocator<pair<const K, V>>,
+         typename Probe = RandomProbing>
+class BasicHashTable {
+public:
+    // TYPE DEFINITIONS
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using probe_policy = Probe;
+
+    // String keys are kept as InlineKeys - in the bucket, or in the table's key arena when longer than
+    // InlineKey::INLINE_CAPACITY - whenever the hash and equality also accept string_view
+    static constexpr bool INLINE_KEYS =
+        is_same_v<K, string> && table_detail::IS_TRANSPARENT<Hash> && table_detail::IS_TRANSPARENT<KeyEqual>;
+    using Bucket = BasicHashTableBucket<conditional_t<INLINE_KEYS, bucket_detail::InlineKey, K>, V,
+                                        CACHES_HASH_BY_DEFAULT<K>>;
 
-class HashTable {
 private:
+    static constexpr bool TRANSPARENT =
+        table_detail::IS_TRANSPARENT<Hash> && table_detail::IS_TRANSPARENT<KeyEqual>;
+
+    template<typename L>
+    using key_arg = typename table_detail::KeyArg<TRANSPARENT>::template type<L, K>;
+
+    using BucketAllocator = typename allocator_traits<Alloc>::template rebind_alloc<Bucket>;
+    using ControlAllocator = typename allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+    using CharAllocator = typename allocator_traits<Alloc>::template rebind_alloc<char>;
+    using StoredKey = conditional_t<INLINE_KEYS, bucket_detail::InlineKey, K>;  // The key as a bucket holds it
+    using KeyView = conditional_t<INLINE_KEYS, string_view, const K&>;          // The key as lookups see it
+
+    // One generation of the table: control bytes, buckets and the values used to index them
+    struct Storage {
+        vector<uint8_t, ControlAllocator> control;  // One state/tag byte per bucket, scanned by probes
+        vector<Bucket, BucketAllocator> buckets;    // Keys and values, read only when a control byte matches
+        size_t mask = 0;                            // capacity - 1; capacity is always a power of two
+        unsigned shift = 63;                        // 64 - log2(capacity), used by homeIndex()
+        size_t tombstones = 0;                      // EAR buckets - probes walk past them like live entries
+
+        explicit Storage(const Alloc& alloc) : control(ControlAllocator(alloc)), buckets(BucketAllocator(alloc)) {}
+        size_t capacity() const { return buckets.size(); }
+    };
+
+    // Where a key was found: its bucket index and which generation holds it
+    struct Position {
+        size_t index = SIZE_MAX;   // Bucket index, SIZE_MAX if the key is absent
+        bool inOld = false;        // Bucket is in oldTable (an incremental resize is in progress)
+        bool found() const { return index != SIZE_MAX; }
+    };
+
+    // Fewest old buckets moved over by each insert/emplace/remove/operator[] during an incremental resize.
+    // A resize leaves the new table half as full as its own resize point, so the old buckets have to be
+    // moved within max_load_factor() * capacity / 2 inserts: migrateStep() raises the step above this
+    // (to about 1 / max_load_factor()) for load factors below 1/16
+    static constexpr size_t MIGRATE_STEP = 16;
+
+    // insert_bulk() prefetches the home bucket of the entry this many places ahead, so the cache
+    // misses of a large batch overlap instead of being paid one after another
+    static constexpr size_t BULK_PREFETCH_DISTANCE = 16;
+
+    // get_many()/contains_many() hash and prefetch this many keys before resolving any of them;
+    // enough to keep the memory system busy without prefetched lines being evicted before use
+    static constexpr size_t LOOKUP_BATCH = 32;
+
+    // A parallel rehash hands out the old buckets in ranges of this many, so workers that finish
+    // early take more ranges instead of waiting for the slowest one
+    static constexpr size_t REHASH_CHUNK = size_t(1) << 14;
+
     // PRIVATE MEMBER VARIABLES
-    vector<HashTableBucket> tableData;  // The actual hash table storage (array of buckets)
-    vector<size_t> offsets;             // Pseudo-random probing sequence for collision resolution
-    size_t numItems;                    // Counter for number of key-value pairs currently stored
+    Storage tableData;                  // The actual hash table storage
+    Storage oldTable;                   // Previous storage while an incremental resize drains it (else empty)
+    size_t migrated;                    // Old buckets already moved into tableData
+    bool incremental;                   // Spread each resize over later operations
+    size_t numItems;                    // Counter for number of key-value pairs currently stored (both generations)
+    double maxLoad;                     // Resize when live entries plus tombstones reach this fraction of the buckets
+    size_t minCapacity;                 // Auto-shrink never goes below this (initial capacity or reserve())
+    size_t rehashThreads;               // Workers for a large rehash, 0 for one per hardware thread
+    vector<char, CharAllocator> keyArena;  // Append-only storage of long inline keys (INLINE_KEYS only)
+    size_t arenaGarbage;                // Arena bytes of keys removed since the arena was last compacted
+    Hash hashPolicy;                    // Hash policy instance
+    KeyEqual keyEqual;                  // Key equality instance
 
     // PRIVATE HELPER METHODS
-    size_t hashFunction(const string& key) const;  // Convert key to array index
-    void generateOffsets(size_t size);             // Create pseudo-random probing sequence
+    template<typename KeyLike>
+    size_t hashFunction(const KeyLike& key) const; // Full hash of a key (not yet reduced to an index)
+    size_t homeIndex(const Storage& table, size_t hash) const;  // Reduce a full hash to a bucket index
+    size_t bucketHash(const Bucket& bucket) const; // Cached hash, or recomputed for compact buckets
+    KeyView keyOf(const Bucket& bucket) const;     // A bucket's key: const K&, or a string_view of an InlineKey
+    template<typename KeyLike>
+    StoredKey storeKey(KeyLike&& key);             // The key as a new bucket holds it (long inline keys go to the arena)
+    void releaseKey(const Bucket& bucket);         // Count a removed key's arena bytes as garbage
+    void compactKeyArena();                        // Rewrite the arena without removed keys once they are half of it
+    template<typename KeyLike>
+    bool bucketMatches(const Storage& table, size_t index, size_t hash, const KeyLike& key) const;  // Tag, hash, then key compare
+    void allocateBuckets(size_t capacity);         // Fresh empty buckets and control bytes, mask and shift
     void resizeIfNeeded();                         // Check and perform table resizing
-    size_t findKeyIndex(const string& key) const;  // Find index of key using probing
+    void rehash(size_t newCapacity);               // Move all entries into newCapacity fresh buckets
+    void rehashParallel(Storage& previous, size_t workers);  // rehash()'s move, split over worker threads
+    void rehashInPlace();                          // Drop all tombstones without allocating
+    size_t capacityFor(size_t count) const;        // Smallest capacity holding count entries within maxLoad
+    void shrinkIfSparse();                         // Auto-shrink after mass removal
+    void relocate(Bucket& bucket);                 // Move one entry into its first free bucket in tableData
+    void migrateBuckets(size_t count);             // Move up to count old buckets over (incremental resize)
+    size_t migrateStep() const;                    // Old buckets per operation: enough to finish before the next resize
+    void occupy(size_t index, size_t hash);        // Take the free bucket a walk found for a new entry
+    void erase(Storage& table, size_t index);      // Empty one bucket: EAR, or a backward shift (Robin Hood)
+    template<typename KeyLike>
+    size_t findKeyIndex(const Storage& table, const KeyLike& key, size_t hash) const;  // Find index of key using probing
+    template<typename KeyLike>
+    Position locate(const KeyLike& key) const;     // Find a key in either generation
+    template<typename KeyLike>
+    Position locate(const KeyLike& key, size_t hash) const;  // The same with the hash already computed
+    template<typename KeyLike>
+    size_t findInsertIndex(const KeyLike& key, size_t hash, bool& found) const;  // One walk: key's index or free slot
+    template<typename KeyLike, typename... Args>
+    pair<V*, bool> findOrInsert(const KeyLike& key, Args&&... args);  // One walk: the key's value, or a new V(args...)
+    size_t findFreeIndex(size_t hash) const;       // First empty bucket on a hash's probe walk
+    size_t claimFreeIndex(size_t hash);            // The same, taken with an atomic compare-and-swap
+    template<typename KeyLike, typename Visit>
+    size_t lookupBatch(span<const KeyLike> keys, Visit visit) const;  // Hash, prefetch, then resolve each chunk
+    template<typename Entries>
+    size_t insertBulk(Entries& entries, bool moveEntries, DuplicatePolicy policy);  // Shared by both insert_bulk()s
+
+    // GROUP PROBING - used instead of the three walks above when Probe::GROUPED
+    template<typename KeyLike>
+    size_t findKeyIndexGrouped(const Storage& table, const KeyLike& key, size_t hash) const;
+    template<typename KeyLike>
+    size_t findInsertIndexGrouped(const KeyLike& key, size_t hash, bool& found) const;
+    size_t findFreeIndexGrouped(size_t hash) const;
+
+    // ROBIN HOOD - used instead of the three walks above when Probe::ROBIN_HOOD
+    template<typename KeyLike>
+    size_t findKeyIndexRobinHood(const Storage& table, const KeyLike& key, size_t hash) const;
+    template<typename KeyLike>
+    size_t findInsertIndexRobinHood(const KeyLike& key, size_t hash, bool& found) const;
+    size_t findFreeIndexRobinHood(size_t hash) const;
+    size_t distanceAt(const Storage& table, size_t index) const;  // How far bucket index's entry is from home
+    void makeRoom(size_t index);                   // Push the run starting at index one bucket on
+
+#ifdef HASHTABLE_STATS
+    mutable ProbeStats stats;                      // Probe counters for the benchmark
+    void recordProbes(size_t count) const;         // Add one walk of `count` buckets
+#endif
 
 public:
     // PUBLIC CONSTANTS
-    static const size_t DEFAULT_INITIAL_CAPACITY = 8;  // Default table size
+    static constexpr size_t DEFAULT_INITIAL_CAPACITY = 8;  // Default table size
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.5;  // Default resize threshold
+    static constexpr double MAX_MAX_LOAD_FACTOR = 0.95;     // Highest threshold max_load_factor() accepts
+    static constexpr size_t PARALLEL_REHASH_MIN = size_t(1) << 20;  // Entries from which a rehash uses worker threads
 
     // CONSTRUCTOR
-    HashTable(size_t initCapacity = 8);  // Create hash table with given capacity (default 8)
+    // Create hash table with given capacity (default 8, rounded up to a power of two)
+    explicit BasicHashTable(size_t initCapacity = DEFAULT_INITIAL_CAPACITY, const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
 
     //MAP OPERATIONS
-    bool insert(string key, int value);           // Insert key-value pair (no duplicates)
-    bool remove(string key);                      // Remove key-value pair
-    bool contains(const string& key) const;       // Check if key exists
-    optional<int> get(const string& key) const;   // Get value for key
-    int& operator[](const string& key);           // Array-style access (get/set)
+    // With transparent Hash/KeyEqual (the string default) lookups accept string_view or const char*,
+    // so callers holding a buffer slice never allocate; otherwise they take const K&
+    bool insert(K key, V value);                  // Insert key-value pair (no duplicates), key is moved in
+    template<typename KeyArg = K>
+    bool emplace(const key_arg<KeyArg>& key, V value);  // Insert, building the stored key only if it is new
+    template<typename KeyArg = K>
+    bool remove(const key_arg<KeyArg>& key);      // Remove key-value pair
+    template<typename KeyArg = K>
+    bool contains(const key_arg<KeyArg>& key) const;    // Check if key exists
+    template<typename KeyArg = K>
+    optional<V> get(const key_arg<KeyArg>& key) const;  // Get value for key
+    template<typename KeyArg = K>
+    V* find(const key_arg<KeyArg>& key);          // Pointer to the stored value, nullptr if missing
+    template<typename KeyArg = K>
+    const V* find(const key_arg<KeyArg>& key) const;    // Read-only pointer to the stored value
+    template<typename KeyArg = K>
+    V& operator[](const key_arg<KeyArg>& key);    // Array-style access (get/set), inserting V() for a new key
+    template<typename KeyArg = K, typename... Args>
+    pair<V*, bool> try_emplace(const key_arg<KeyArg>& key, Args&&... args);  // Stored value, or a new V(args...); true if inserted
+    template<typename KeyArg = K>
+    bool insert_or_assign(const key_arg<KeyArg>& key, V value);  // Insert, or overwrite the stored value; true if inserted
+
+    // BATCHED LOOKUPS
+    // Hash a batch of keys, prefetch every home bucket, then resolve the probes, so the cache misses
+    // of different keys overlap instead of stalling one lookup at a time. out[i] receives the result
+    // for keys[i] (out must be at least as long as keys, else invalid_argument); both return the hit count
+    template<typename KeyArg = K>
+    size_t get_many(span<const key_arg<KeyArg>> keys, span<optional<V>> out) const;
+    template<typename KeyArg = K>
+    size_t contains_many(span<const key_arg<KeyArg>> keys, span<bool> out) const;
 
     // UTILITY METHODS
-    vector<string> keys() const;  // Get all keys currently in table
+    vector<K> keys() const;       // Get all keys currently in table
+    template<typename Fn>
+    void for_each(Fn fn) const;   // Call fn(key, value) for every entry, in bucket order (string keys may come as string_view)
     double alpha() const;         // Calculate current load factor
     size_t capacity() const;      // Get total number of buckets
     size_t size() const;          // Get number of key-value pairs
+    size_t tombstoneCount() const;  // Get number of EAR buckets (removed entries probes still walk past)
+    void compact();               // Turn every EAR bucket back into ESS, in place
+
+    // LOAD FACTOR AND SIZING
+    // Higher load factors save memory at the cost of longer probe walks; every probe policy
+    // reads only control bytes while walking, and GroupProbing is built for 0.85-0.9
+    double max_load_factor() const;           // Load that triggers a resize
+    void max_load_factor(double load);        // Set it, in (0, MAX_MAX_LOAD_FACTOR] (throws invalid_argument otherwise)
+    void reserve(size_t count);               // Size once so count entries fit without any resize
+    void shrink_to_fit();                     // Smallest capacity holding size() entries within max_load_factor()
+
+    // BULK BUILDING
+    // Size the table once for the whole batch, hash every key in one tight loop, then place the
+    // entries without any per-insert resize checks - for loading a large data set at startup
+    size_t insert_bulk(span<const pair<K, V>> entries,
+                       DuplicatePolicy policy = DuplicatePolicy::FIRST_WINS);  // Copies the entries in
+    size_t insert_bulk(vector<pair<K, V>>&& entries,
+                       DuplicatePolicy policy = DuplicatePolicy::FIRST_WINS);  // Moves keys and values out of the vector
+    template<typename Range>
+    static BasicHashTable from_range(Range&& range,
+                                     DuplicatePolicy policy = DuplicatePolicy::FIRST_WINS);  // New table built by insert_bulk()
+
+    // INCREMENTAL RESIZING
+    // When enabled, a resize allocates the new array and later mutating operations move
+    // migrateStep() old buckets each (at least MIGRATE_STEP), so no single insert pays for the whole table.
+    // Lookups check both arrays until the old one is empty
+    void setIncrementalResize(bool enabled);  // Turn incremental resizing on/off (off finishes any migration)
+    bool incrementalResize() const;           // Is incremental resizing on
+    bool isMigrating() const;                 // Is an incremental resize still moving entries
+    double migrationProgress() const;         // Fraction of old buckets moved (1.0 when not migrating)
+    void finishMigration();                   // Move all remaining old entries now
+
+    // PARALLEL REHASH
+    // A full rehash of PARALLEL_REHASH_MIN or more entries splits the old buckets into ranges that
+    // worker threads move at the same time, each taking its destination buckets with an atomic
+    // compare-and-swap on their control bytes. Smaller tables and in-place cleanups stay single-threaded
+    void setRehashThreads(size_t threads);    // Workers for large rehashes (0: one per hardware thread, 1: never parallel)
+    size_t rehashThreadCount() const;         // Workers a large rehash would use
+
+#ifdef HASHTABLE_STATS
+    // BENCHMARK INSTRUMENTATION
+    const ProbeStats& probeStats() const;  // Probe counters since construction or last reset
+    void resetProbeStats();                // Zero the probe counters
+#endif
 
     // FRIEND FUNCTION FOR OUTPUT - Allows printing entire hash table
-    friend ostream& operator<<(ostream& os, const HashTable& hashTable);
+    template<typename TK, typename TV, typename TH, typename TE, typename TA, typename TP>
+    friend ostream& operator<<(ostream& os, const BasicHashTable<TK, TV, TH, TE, TA, TP>& hashTable);
 };
 
-#endif
\ No newline at end of file
+// The table used throughout the project: string keys, int values, default hash
+using HashTable = BasicHashTable<>;
+
+// The same table with another probe policy, e.g. ProbingHashTable<LinearProbing>
+template<typename Probe, typename K = string, typename V = int, typename Hash = DefaultHash<K>>
+using ProbingHashTable = BasicHashTable<K, V, Hash, equal_to<>, allocator<pair<const K, V>>, Probe>;
+
+// The same table probing with SIMD control-byte groups instead of the pseudo-random sequence
+template<typename K = string, typename V = int, typename Hash = DefaultHash<K>>
+using GroupHashTable = ProbingHashTable<GroupProbing, K, V, Hash>;
+
+// The same table with Robin Hood insertion and backward-shift deletion (no tombstones)
+template<typename K = string, typename V = int, typename Hash = DefaultHash<K>>
+using RobinHoodHashTable = ProbingHashTable<RobinHoodProbing, K, V, Hash>;
+
+// The default table with its arrays on huge pages, for tables far larger than the TLB reaches
+template<typename K = string, typename V = int, typename Hash = DefaultHash<K>>
+using HugePageHashTable = BasicHashTable<K, V, Hash, equal_to<>, HugePageAllocator<pair<const K, V>>>;
+
+// Template member definitions
+#include "HashTable.tpp"
+
+// HashTable itself is compiled once, in HashTable.cpp
+extern template class BasicHashTableBucket<string, int>;
+extern template class BasicHashTableBucket<bucket_detail::InlineKey, int>;
+extern template class BasicHashTable<string, int>;
+
+#endif
@@ -0,0 +1,1478 @@
+/* HashTable.tpp
+Template member definitions for BasicHashTableBucket and BasicHashTable, included at the
+bottom of HashTable.h. Open addressing with pseudo-random probing; see HashTable.h for the interface.
+ */
+
+#ifndef HASHTABLE_TPP
+#define HASHTABLE_TPP
+
+// Probe counting compiles away unless HASHTABLE_STATS is defined
+#ifdef HASHTABLE_STATS
+#define HT_RECORD_PROBES(count) recordProbes(count)
+#else
+#define HT_RECORD_PROBES(count)
+#endif
+
+// Shorthands for the template headers of out-of-line member definitions
+#define HT_BUCKET_TEMPLATE template<typename K, typename V, bool CacheHash>
+#define HT_BUCKET BasicHashTableBucket<K, V, CacheHash>
+#define HT_TEMPLATE template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, typename Probe>
+#define HT_CLASS BasicHashTable<K, V, Hash, KeyEqual, Alloc, Probe>
+
+// HASHTABLEBUCKET CLASS IMPLEMENTATION
+/*
+Default constructor - creates a bucket with an empty key and value
+Whether a bucket is in use is recorded by the table's control byte (ESS for new buckets)
+ */
+HT_BUCKET_TEMPLATE
+HT_BUCKET::BasicHashTableBucket() : key(), value() {}
+
+/*
+ Parameterized constructor - creates a bucket with specific key-value pair
+ */
+HT_BUCKET_TEMPLATE
+HT_BUCKET::BasicHashTableBucket(K key, V value, size_t hash)
+    : key(std::move(key)), value(std::move(value)) {
+    this->setStoredHash(hash);
+}
+
+/*
+Load a new key-value pair into this bucket
+The key is moved in, so callers that pass an rvalue (or a freshly built key) never pay for a second copy.
+The full hash is kept (unless the bucket uses the compact layout) so a tag match can be confirmed
+with one integer compare and resizing can place the entry without hashing again
+ */
+HT_BUCKET_TEMPLATE
+void HT_BUCKET::load(K newKey, V newValue, size_t newHash) {
+    key = std::move(newKey);     // Store the new key
+    value = std::move(newValue); // Store the new value
+    this->setStoredHash(newHash); // Remember the key's full hash
+}
+
+/*
+Clear the bucket - resets the key and value so a removed entry does not keep its storage alive
+(the table marks the bucket Empty After Remove in its control byte)
+ */
+HT_BUCKET_TEMPLATE
+void HT_BUCKET::clear() {
+    key = K();              // Clear the key (releases any heap storage it owned)
+    value = V();            // Clear the value
+    this->setStoredHash(0); // Clear the cached hash
+}
+
+// GETTER METHODS - Provide read-only access to private members
+//Get the key stored in this bucket - returned by reference so probe comparisons never copy it
+
+HT_BUCKET_TEMPLATE
+const K& HT_BUCKET::getKey() const {
+    return key;
+}
+
+// Get the value stored in this bucket
+
+HT_BUCKET_TEMPLATE
+const V& HT_BUCKET::getValue() const {
+    return value;
+}
+
+// Get the full hash cached when the key was loaded (always 0 for compact buckets)
+
+HT_BUCKET_TEMPLATE
+size_t HT_BUCKET::getHash() const {
+    return this->getStoredHash();
+}
+
+/* Update the value in this bucket (key remains the same)
+ Used by operator[] for assignment operations
+ */
+HT_BUCKET_TEMPLATE
+void HT_BUCKET::setValue(V newValue) {
+    value = std::move(newValue);
+}
+
+/* Output operator for a bucket - prints its key-value pair
+The table only prints buckets whose control byte marks them NORMAL
+ */
+template<typename K, typename V, bool CacheHash>
+ostream& operator<<(ostream& os, const BasicHashTableBucket<K, V, CacheHash>& bucket) {
+    os << "<" << bucket.key << ", " << bucket.value << ">";
+    return os;
+}
+
+// HASHTABLE CLASS IMPLEMENTATION
+
+/*
+Constructor - initializes hash table with specified capacity
+initCapacity: initial number of buckets (defaults to 8), rounded up to the next power of two
+so that bucket indices can be computed with a mask instead of a division
+Creates empty buckets; incremental resizing starts off and the table resizes at half full
+ */
+HT_TEMPLATE
+HT_CLASS::BasicHashTable(size_t initCapacity, const Hash& hash, const KeyEqual& equal, const Alloc& alloc)
+    : tableData(alloc), oldTable(alloc), migrated(0), incremental(false), numItems(0),
+      maxLoad(DEFAULT_MAX_LOAD_FACTOR), minCapacity(std::bit_ceil(initCapacity == 0 ? size_t(1) : initCapacity)),
+      rehashThreads(0), keyArena(CharAllocator(alloc)), arenaGarbage(0), hashPolicy(hash), keyEqual(equal) {
+    allocateBuckets(minCapacity);
+}
+
+/*Replace tableData with `capacity` empty buckets (a power of two), all marked ESS
+Also resets the mask/shift used for indexing (probe sequences are computed from them, no table).
+Group probing needs at least one whole group of control bytes; a smaller table pads its
+control array with SENTINEL bytes, which no probe ever matches
+ */
+HT_TEMPLATE
+void HT_CLASS::allocateBuckets(size_t capacity) {
+    if constexpr (Probe::GROUPED) {
+        tableData.control.assign(std::max(capacity, GroupProbing::GROUP_WIDTH), bucket_detail::SENTINEL);
+        std::fill(tableData.control.begin(), tableData.control.begin() + capacity, bucket_detail::ESS);
+    } else {
+        tableData.control.assign(capacity, bucket_detail::ESS);  // Every bucket starts Empty Since Start
+    }
+    tableData.buckets.clear();
+    tableData.buckets.resize(capacity);   // Create vector with specified capacity
+    tableData.tombstones = 0;
+    tableData.mask = capacity - 1;
+    // 64 - log2(capacity); a one-bucket table keeps 63 and relies on the mask instead
+    tableData.shift = capacity > 1 ? 64 - static_cast<unsigned>(std::countr_zero(capacity)) : 63;
+}
+
+/*Hash function - converts a key to a full-width hash value using the Hash policy
+The result is not reduced to the table size here - buckets cache it and homeIndex() maps it to a bucket
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::hashFunction(const KeyLike& key) const {
+    return hashPolicy(key);
+}
+
+/*Map a full hash to its home bucket in `table`
+Fibonacci hashing: multiply by 2^64 / golden ratio and keep the top log2(capacity) bits.
+This is a multiply and a shift instead of a 64-bit division, and it spreads weak hashes
+(such as short numeric keys) across the whole table instead of using only their low bits
+ */
+HT_TEMPLATE
+size_t HT_CLASS::homeIndex(const Storage& table, size_t hash) const {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 11400714819323198485ull) >> table.shift) & table.mask;
+}
+
+/*Full hash of the key stored in a NORMAL bucket
+Read from the bucket when it caches hashes; compact buckets (small trivially copyable keys) rehash the key
+ */
+HT_TEMPLATE
+size_t HT_CLASS::bucketHash(const Bucket& bucket) const {
+    if constexpr (Bucket::CACHES_HASH) {
+        return bucket.getHash();
+    } else {
+        return hashFunction(keyOf(bucket));
+    }
+}
+
+/*The key stored in a bucket, as lookups and callers see it
+An InlineKey is read through the key arena and comes back as a string_view; other keys as themselves
+ */
+HT_TEMPLATE
+auto HT_CLASS::keyOf(const Bucket& bucket) const -> KeyView {
+    if constexpr (INLINE_KEYS) {
+        return bucket.getKey().view(keyArena.data());
+    } else {
+        return bucket.getKey();
+    }
+}
+
+/*Build the key a new bucket will hold
+A string key longer than InlineKey::INLINE_CAPACITY is appended to the key arena here, so call this
+only once the key is known to be new
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+auto HT_CLASS::storeKey(KeyLike&& key) -> StoredKey {
+    if constexpr (INLINE_KEYS) {
+        bucket_detail::InlineKey stored;
+        stored.assign(string_view(key), keyArena);
+        return stored;
+    } else {
+        return StoredKey(std::forward<KeyLike>(key));
+    }
+}
+
+//Account for the arena bytes of a key about to be removed (the arena itself only ever grows)
+
+HT_TEMPLATE
+void HT_CLASS::releaseKey(const Bucket& bucket) {
+    if constexpr (INLINE_KEYS) {
+        arenaGarbage += bucket.getKey().arenaBytes();
+    }
+}
+
+/*Drop the bytes of removed keys from the key arena
+Runs once they are at least half of the arena and at least one byte per bucket, so the pass over
+every bucket is paid for by the removals that made the garbage. Live long keys are copied, in
+bucket order, into a new arena and their buckets are pointed at the copies
+ */
+HT_TEMPLATE
+void HT_CLASS::compactKeyArena() {
+    if constexpr (INLINE_KEYS) {
+        if (arenaGarbage * 2 < keyArena.size() || arenaGarbage < tableData.capacity() + oldTable.capacity()) return;
+        vector<char, CharAllocator> compacted(keyArena.get_allocator());
+        compacted.reserve(keyArena.size() - arenaGarbage);
+        for (Storage* table : {&tableData, &oldTable}) {
+            for (size_t i = 0; i < table->capacity(); i++) {
+                if (bucket_detail::isNormal(table->control[i])) {
+                    table->buckets[i].getKeyRef().moveTo(keyArena.data(), compacted);
+                }
+            }
+        }
+        keyArena.swap(compacted);
+        arenaGarbage = 0;
+    }
+}
+
+/*Does bucket `index` of `table` hold this key?
+The control byte rejects empty buckets and all but 1 in 128 other keys without reading the bucket;
+on a tag match the cached hash and then the key itself are compared. Robin Hood control bytes carry
+a 3-bit tag beside the distance, and its walk only asks about entries as far from home as the key
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+bool HT_CLASS::bucketMatches(const Storage& table, size_t index, size_t hash, const KeyLike& key) const {
+    if constexpr (Probe::ROBIN_HOOD) {
+        if (!RobinHoodProbing::tagMatches(table.control[index], hash)) return false;
+    } else {
+        if (table.control[index] != bucket_detail::tagOf(hash)) return false;
+    }
+    const Bucket& bucket = table.buckets[index];
+    if constexpr (Bucket::CACHES_HASH) {
+        if (bucket.getHash() != hash) return false;
+    }
+    return keyEqual(keyOf(bucket), key);
+}
+
+/**
+ * Check if table needs resizing and resize if necessary
+ * Acts when live entries plus tombstones (EAR buckets) reach max_load_factor() of the buckets
+ * (0.5 by default), since a miss has to walk past both. Tombstones are not counted by alpha(),
+ * so a table with heavy insert/remove churn would otherwise fill up with them while reporting
+ * a low load factor:
+ * - live entries below half the threshold: the rest are tombstones, so rehash in place
+ * - otherwise: double the table capacity and rehash all existing elements - at once, or
+ *   a few buckets per later operation when incremental resizing is on
+ */
+HT_TEMPLATE
+void HT_CLASS::resizeIfNeeded() {
+    double limit = maxLoad * static_cast<double>(tableData.capacity());
+
+    // Check if current load factor (tombstones included) exceeds threshold
+    if (static_cast<double>(numItems + tableData.tombstones) >= limit) {
+        if (static_cast<double>(numItems) < limit / 2) {
+            rehashInPlace();  // Mostly tombstones: clear them instead of growing
+            return;
+        }
+        size_t newCapacity = tableData.capacity() * 2;  // Double the capacity, so it stays a power of two
+        if (!incremental) {
+            rehash(newCapacity);
+            return;
+        }
+        finishMigration();  // Normally already done - see migrateStep()
+
+        // Keep the current arrays as the old generation and start filling a fresh one
+        oldTable = std::move(tableData);
+        tableData = Storage(Alloc(oldTable.buckets.get_allocator()));
+        allocateBuckets(newCapacity);
+        migrated = 0;
+    }
+}
+
+/*Move every entry into a fresh array of `newCapacity` buckets (a power of two, larger than size())
+The old arrays are moved out rather than copied, so peak memory is the old plus the new arrays and
+no key bytes are ever duplicated: each bucket is move-assigned into its new slot, which hands over
+a string's heap buffer instead of copying it (inline keys keep their arena bytes where they are; removed
+ones are dropped from the arena first, see compactKeyArena()). Keys are already unique and their hashes are cached,
+so entries go straight to the first free bucket without hashing or comparing keys.
+From PARALLEL_REHASH_MIN entries on, the moves are split over worker threads (rehashParallel())
+ */
+HT_TEMPLATE
+void HT_CLASS::rehash(size_t newCapacity) {
+    finishMigration();
+    compactKeyArena();
+    Storage previous = std::move(tableData);
+    tableData = Storage(Alloc(previous.buckets.get_allocator()));
+
+    // Fresh empty buckets, all ESS; this is where the new array is allocated
+    allocateBuckets(newCapacity);
+
+    // Robin Hood placement moves other entries around, which atomic claims cannot do: it stays sequential
+    if constexpr (!Probe::ROBIN_HOOD) {
+        size_t chunks = (previous.capacity() + REHASH_CHUNK - 1) / REHASH_CHUNK;
+        size_t workers = numItems >= PARALLEL_REHASH_MIN ? std::min(rehashThreadCount(), chunks) : 1;
+        if (workers > 1) {
+            rehashParallel(previous, workers);
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < previous.capacity(); i++) {
+        // Only move buckets that have valid data
+        if (bucket_detail::isNormal(previous.control[i])) {
+            relocate(previous.buckets[i]);
+        }
+    }
+}
+
+/* The move of rehash() on `workers` threads (the calling thread is one of them)
+Workers take REHASH_CHUNK old buckets at a time. Each entry goes to the first free bucket of its
+probe walk that it manages to claim: the control byte is switched from ESS to the entry's tag with
+a compare-and-swap, so two workers never fill the same bucket and a lost race just moves on along
+the walk. A bucket only ever goes from ESS to NORMAL, so every bucket an entry passes stays
+occupied and every later lookup finds it, whatever order the workers ran in. Buckets are filled by
+the worker that claimed them, and joining the workers publishes everything to the calling thread
+ */
+HT_TEMPLATE
+void HT_CLASS::rehashParallel(Storage& previous, size_t workers) {
+    const size_t chunks = (previous.capacity() + REHASH_CHUNK - 1) / REHASH_CHUNK;
+    atomic<size_t> nextChunk{0};
+    auto work = [&] {
+        for (size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++) {
+            size_t end = std::min(previous.capacity(), (chunk + 1) * REHASH_CHUNK);
+            for (size_t i = chunk * REHASH_CHUNK; i < end; i++) {
+                if (!bucket_detail::isNormal(previous.control[i])) continue;
+                size_t index = claimFreeIndex(bucketHash(previous.buckets[i]));
+                tableData.buckets[index] = std::move(previous.buckets[i]);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    try {
+        for (size_t w = 1; w < workers; w++) threads.emplace_back(work);
+    } catch (const system_error&) {
+        // No more threads available: the ones already running (and this one) share out the chunks
+    }
+    work();
+    for (thread& worker : threads) worker.join();
+}
+
+/* Smallest power-of-two capacity that holds `count` entries without reaching max_load_factor()
+(a resize is only checked before an insert, so count entries fit when count <= maxLoad * capacity)
+ */
+HT_TEMPLATE
+size_t HT_CLASS::capacityFor(size_t count) const {
+    double needed = std::ceil(static_cast<double>(count) / maxLoad);
+    return std::bit_ceil(std::max<size_t>(static_cast<size_t>(needed), 1));
+}
+
+/* Auto-shrink - called after each remove
+Once live entries drop below an eighth of the resize threshold, the table moves to the capacity
+that leaves it a quarter to half as full as the threshold, so neither a shrink nor a grow
+follows soon after. Never shrinks below the initial or reserved capacity
+ */
+HT_TEMPLATE
+void HT_CLASS::shrinkIfSparse() {
+    if (tableData.capacity() <= minCapacity) return;
+    if (static_cast<double>(numItems) * 8 < maxLoad * static_cast<double>(tableData.capacity())) {
+        size_t target = std::max(minCapacity, capacityFor(numItems * 2));
+        if (target < tableData.capacity()) rehash(target);
+    }
+}
+
+/* Move one entry from another generation into the first free bucket of its probe walk in tableData
+The key, value and cached hash move over; the source bucket is left moved-from
+ */
+HT_TEMPLATE
+void HT_CLASS::relocate(Bucket& bucket) {
+    size_t hash = bucketHash(bucket);
+    size_t index = findFreeIndex(hash);
+    occupy(index, hash);
+    tableData.buckets[index] = std::move(bucket);
+}
+
+/* Take bucket `index` of tableData, which a walk found free for a new entry with this hash;
+the caller then loads the entry into it. Reusing an EAR bucket leaves one tombstone less.
+With Robin Hood the bucket may hold an entry closer to its home: that entry and the rest of its run
+move one bucket on first, and the control byte records the new entry's distance from home
+ */
+HT_TEMPLATE
+void HT_CLASS::occupy(size_t index, size_t hash) {
+    if constexpr (Probe::ROBIN_HOOD) {
+        makeRoom(index);
+        tableData.control[index] = RobinHoodProbing::control((index - homeIndex(tableData, hash)) & tableData.mask, hash);
+    } else {
+        if (tableData.control[index] == bucket_detail::EAR) tableData.tombstones--;
+        tableData.control[index] = bucket_detail::tagOf(hash);
+    }
+}
+
+/* Empty bucket `index` of `table` after its entry was removed
+Normally it becomes EAR, a tombstone later walks pass over. In a Robin Hood table every following
+entry of the run moves back one bucket instead (backward-shift deletion), which keeps the run
+ordered by distance and leaves no tombstone; only the old array of an incremental resize, whose
+entries must stay where the migration expects them, still gets EAR buckets
+ */
+HT_TEMPLATE
+void HT_CLASS::erase(Storage& table, size_t index) {
+    releaseKey(table.buckets[index]);
+    if constexpr (Probe::ROBIN_HOOD) {
+        if (&table == &tableData) {
+            size_t hole = index;
+            for (size_t next = (hole + 1) & table.mask;; next = (next + 1) & table.mask) {
+                uint8_t state = table.control[next];
+                if (state == bucket_detail::ESS) break;  // End of the run
+                size_t distance = distanceAt(table, next);
+                if (distance == 0) break;                // An entry at home stays there
+                table.buckets[hole] = std::move(table.buckets[next]);
+                table.control[hole] = RobinHoodProbing::withDistance(state, distance - 1);
+                hole = next;
+            }
+            table.control[hole] = bucket_detail::ESS;
+            table.buckets[hole].clear();
+            return;
+        }
+    }
+    table.control[index] = bucket_detail::EAR;  // Mark bucket as Empty After Remove
+    table.buckets[index].clear();  // Release the key and value
+    table.tombstones++;
+}
+
+/* Rehash without allocating: drop every tombstone by re-placing the entries inside the same arrays
+First every NORMAL bucket is marked EAR ("still to place") and every old EAR becomes ESS.
+Each entry still to place then goes to the first ESS-or-EAR bucket on its probe walk:
+- its own bucket: it just becomes NORMAL again
+- an ESS bucket: it moves there
+- another entry still to place: the two swap and the displaced entry is placed next
+An entry always lands on the first bucket of its walk not already holding a placed entry,
+and placed entries never move again, so no lookup can meet an ESS bucket before its key
+ */
+HT_TEMPLATE
+void HT_CLASS::rehashInPlace() {
+    finishMigration();
+    compactKeyArena();
+    if constexpr (Probe::ROBIN_HOOD) {
+        return;  // Backward-shift deletion never leaves a tombstone to clean up
+    }
+    auto& control = tableData.control;
+    auto& buckets = tableData.buckets;
+
+    for (size_t i = 0; i < tableData.capacity(); i++) {
+        control[i] = bucket_detail::isNormal(control[i]) ? bucket_detail::EAR : bucket_detail::ESS;
+    }
+
+    for (size_t i = 0; i < tableData.capacity(); i++) {
+        while (control[i] == bucket_detail::EAR) {
+            size_t hash = bucketHash(buckets[i]);
+            size_t target = findFreeIndex(hash);
+            if (target == i) {
+                control[i] = bucket_detail::tagOf(hash);  // Already where it belongs
+            } else if (control[target] == bucket_detail::ESS) {
+                buckets[target] = std::move(buckets[i]);
+                buckets[i].clear();
+                control[target] = bucket_detail::tagOf(hash);
+                control[i] = bucket_detail::ESS;
+            } else {
+                std::swap(buckets[i], buckets[target]);  // Bucket i now holds the displaced entry
+                control[target] = bucket_detail::tagOf(hash);
+            }
+        }
+    }
+    tableData.tombstones = 0;
+}
+
+/* Incremental resize step - move up to `count` old buckets into tableData
+Moved buckets become EAR in the old table so its remaining probe walks stay intact and a
+lookup never matches a moved-from key. The old arrays are freed once every bucket has been visited
+ */
+HT_TEMPLATE
+void HT_CLASS::migrateBuckets(size_t count) {
+    size_t end = std::min(oldTable.capacity(), migrated + count);
+    for (; migrated < end; migrated++) {
+        if (bucket_detail::isNormal(oldTable.control[migrated])) {
+            relocate(oldTable.buckets[migrated]);
+            oldTable.control[migrated] = bucket_detail::EAR;
+            oldTable.buckets[migrated].clear();
+        }
+    }
+    if (migrated == oldTable.capacity() && migrated != 0) {
+        oldTable = Storage(Alloc(oldTable.buckets.get_allocator()));  // Release the old arrays
+        migrated = 0;
+    }
+}
+
+/* Old buckets each mutating operation moves during an incremental resize
+The old buckets left are spread over the inserts that still fit below the resize point, so the
+migration always ends before the next resize. Right after a resize that is about 1 / max_load_factor()
+buckets per insert; a table that was over-full for its load factor moves the rest sooner
+@return: at least MIGRATE_STEP buckets
+ */
+HT_TEMPLATE
+size_t HT_CLASS::migrateStep() const {
+    double limit = maxLoad * static_cast<double>(tableData.capacity());
+    double headroom = std::ceil(limit - static_cast<double>(numItems + tableData.tombstones));
+    size_t left = oldTable.capacity() - migrated;
+    size_t step = headroom < 1 ? left : static_cast<size_t>(std::ceil(static_cast<double>(left) / headroom));
+    return std::max(MIGRATE_STEP, step);
+}
+
+/* Helper function to find the array index of a given key in one generation of the table
+Follows the Probe policy's sequence from the home bucket. Each probe reads only the bucket's
+control byte; the key storage is read only when the byte carries the key's tag
+@return: the key's bucket index, or table.capacity() if it is not there
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findKeyIndex(const Storage& table, const KeyLike& key, size_t hash) const {
+    if constexpr (Probe::GROUPED) {
+        return findKeyIndexGrouped(table, key, hash);
+    } else if constexpr (Probe::ROBIN_HOOD) {
+        return findKeyIndexRobinHood(table, key, hash);
+    } else {
+        typename Probe::Sequence probe(homeIndex(table, hash), table.mask);
+
+        // Step 0 is the home bucket; the sequence visits every bucket once within mask + 1 steps
+        for (size_t i = 0; i <= table.mask; i++, probe.next()) {
+            size_t currentIndex = probe.index();
+
+            // If we find a never-used bucket (ESS), stop searching
+            // This means the key cannot exist beyond this point
+            if (table.control[currentIndex] == bucket_detail::ESS) {
+                HT_RECORD_PROBES(i + 1);
+                return table.capacity();  // Return "not found" indicator
+            }
+
+            // Check if current bucket has our key
+            if (bucketMatches(table, currentIndex, hash, key)) {
+                HT_RECORD_PROBES(i + 1);
+                return currentIndex;  // Key found at probe position
+            }
+        }
+
+        HT_RECORD_PROBES(table.mask + 1);
+        return table.capacity();  // Key not found after exhaustive search
+    }
+}
+
+/* Find a key in the current table and, while an incremental resize is running, in the old one
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+typename HT_CLASS::Position HT_CLASS::locate(const KeyLike& key) const {
+    return locate(key, hashFunction(key));
+}
+
+HT_TEMPLATE
+template<typename KeyLike>
+typename HT_CLASS::Position HT_CLASS::locate(const KeyLike& key, size_t hash) const {
+    Position position;
+    size_t index = findKeyIndex(tableData, key, hash);
+    if (index < tableData.capacity()) {
+        position.index = index;
+    } else if (isMigrating()) {
+        index = findKeyIndex(oldTable, key, hash);
+        if (index < oldTable.capacity()) {
+            position.index = index;
+            position.inOld = true;
+        }
+    }
+    return position;
+}
+
+/* Helper used by insert - walks the probe sequence for key exactly once
+Remembers the first EAR bucket it passes so a removed slot can be reused, and stops at
+the first ESS bucket because the key cannot appear beyond it
+@return: index of the key's bucket (found = true), otherwise the bucket the key should be
+loaded into (found = false), or tableData.capacity() if no bucket is free
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findInsertIndex(const KeyLike& key, size_t hash, bool& found) const {
+    if constexpr (Probe::GROUPED) {
+        return findInsertIndexGrouped(key, hash, found);
+    } else if constexpr (Probe::ROBIN_HOOD) {
+        return findInsertIndexRobinHood(key, hash, found);
+    } else {
+        typename Probe::Sequence probe(homeIndex(tableData, hash), tableData.mask);
+        size_t firstFree = tableData.capacity();  // First EAR bucket seen on the walk, if any
+        found = false;
+
+        for (size_t i = 0; i <= tableData.mask; i++, probe.next()) {
+            size_t currentIndex = probe.index();
+            uint8_t state = tableData.control[currentIndex];
+
+            // Never-used bucket: the key is absent, reuse an earlier EAR bucket if we passed one
+            if (state == bucket_detail::ESS) {
+                HT_RECORD_PROBES(i + 1);
+                return firstFree < tableData.capacity() ? firstFree : currentIndex;
+            }
+
+            if (state == bucket_detail::EAR) {
+                if (firstFree == tableData.capacity()) firstFree = currentIndex;
+            } else if (bucketMatches(tableData, currentIndex, hash, key)) {
+                HT_RECORD_PROBES(i + 1);
+                found = true;
+                return currentIndex;  // Key already stored here
+            }
+        }
+
+        HT_RECORD_PROBES(tableData.mask + 1);
+        return firstFree;  // Whole sequence walked without meeting an ESS bucket
+    }
+}
+
+/* Helper used by resizing - first empty bucket on the probe walk for a hash
+Only valid when the key is known not to be in the table already
+ */
+HT_TEMPLATE
+size_t HT_CLASS::findFreeIndex(size_t hash) const {
+    if constexpr (Probe::GROUPED) {
+        return findFreeIndexGrouped(hash);
+    } else if constexpr (Probe::ROBIN_HOOD) {
+        return findFreeIndexRobinHood(hash);
+    } else {
+        typename Probe::Sequence probe(homeIndex(tableData, hash), tableData.mask);
+        for (size_t i = 0; i <= tableData.mask; i++, probe.next()) {
+            if (bucket_detail::isEmpty(tableData.control[probe.index()])) {
+                return probe.index();
+            }
+        }
+        return tableData.capacity();  // Unreachable while the load factor stays below 1
+    }
+}
+
+/* findFreeIndex() for a parallel rehash: walk the same buckets (or groups, bucket by bucket) and
+take the first ESS bucket whose control byte this thread manages to switch to the hash's tag.
+The fresh table has no tombstones, so ESS is the only free state
+@return: the claimed bucket, now tagged
+ */
+HT_TEMPLATE
+size_t HT_CLASS::claimFreeIndex(size_t hash) {
+    const uint8_t tag = bucket_detail::tagOf(hash);
+    auto claim = [&](size_t index) {
+        atomic_ref<uint8_t> control(tableData.control[index]);
+        uint8_t expected = bucket_detail::ESS;
+        return control.load(memory_order_relaxed) == bucket_detail::ESS &&
+               control.compare_exchange_strong(expected, tag, memory_order_relaxed);
+    };
+
+    if constexpr (Probe::GROUPED) {
+        constexpr size_t WIDTH = probe_detail::ControlGroup::WIDTH;
+        const size_t groupMask = tableData.control.size() / WIDTH - 1;
+        size_t group = homeIndex(tableData, hash) / WIDTH;
+        for (size_t step = 0; step <= groupMask; step++) {
+            size_t base = group * WIDTH;
+            for (size_t i = 0; i < WIDTH; i++) {
+                if (claim(base + i)) return base + i;
+            }
+            group = (group + step + 1) & groupMask;
+        }
+    } else {
+        typename Probe::Sequence probe(homeIndex(tableData, hash), tableData.mask);
+        for (size_t i = 0; i <= tableData.mask; i++, probe.next()) {
+            if (claim(probe.index())) return probe.index();
+        }
+    }
+    return tableData.capacity();  // Unreachable while the load factor stays below 1
+}
+
+/* Group probing lookup - compares a whole group of control bytes with the key's tag at once
+Groups are aligned to GROUP_WIDTH and visited in triangular order (g, g+1, g+3, g+6, ...),
+which reaches every group because the group count is a power of two.
+A group holding an ESS byte ends the search, exactly like an ESS bucket in random probing.
+Probe statistics count groups rather than buckets
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findKeyIndexGrouped(const Storage& table, const KeyLike& key, size_t hash) const {
+    using namespace probe_detail;
+    const size_t groupMask = table.control.size() / ControlGroup::WIDTH - 1;
+    const uint8_t tag = bucket_detail::tagOf(hash);
+    size_t group = homeIndex(table, hash) / ControlGroup::WIDTH;
+
+    for (size_t step = 0; step <= groupMask; step++) {
+        size_t base = group * ControlGroup::WIDTH;
+        ControlGroup bytes(table.control.data() + base);
+
+        // Only buckets whose control byte equals the tag are read
+        for (uint32_t candidates = bytes.match(tag); candidates != 0; candidates = clearLowestBit(candidates)) {
+            size_t index = base + lowestBit(candidates);
+            if (bucketMatches(table, index, hash, key)) {
+                HT_RECORD_PROBES(step + 1);
+                return index;
+            }
+        }
+        if (bytes.match(bucket_detail::ESS) != 0) {
+            HT_RECORD_PROBES(step + 1);
+            return table.capacity();  // Never-used bucket in this group: the key is absent
+        }
+        group = (group + step + 1) & groupMask;
+    }
+
+    HT_RECORD_PROBES(groupMask + 1);
+    return table.capacity();
+}
+
+/* Group probing version of findInsertIndex - one walk that either finds the key or
+returns the first free (ESS or EAR) bucket met before the walk ends
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findInsertIndexGrouped(const KeyLike& key, size_t hash, bool& found) const {
+    using namespace probe_detail;
+    const size_t groupMask = tableData.control.size() / ControlGroup::WIDTH - 1;
+    const uint8_t tag = bucket_detail::tagOf(hash);
+    size_t group = homeIndex(tableData, hash) / ControlGroup::WIDTH;
+    size_t firstFree = tableData.capacity();
+    found = false;
+
+    for (size_t step = 0; step <= groupMask; step++) {
+        size_t base = group * ControlGroup::WIDTH;
+        ControlGroup bytes(tableData.control.data() + base);
+
+        for (uint32_t candidates = bytes.match(tag); candidates != 0; candidates = clearLowestBit(candidates)) {
+            size_t index = base + lowestBit(candidates);
+            if (bucketMatches(tableData, index, hash, key)) {
+                HT_RECORD_PROBES(step + 1);
+                found = true;
+                return index;
+            }
+        }
+        uint32_t free = bytes.matchFree();
+        if (firstFree == tableData.capacity() && free != 0) {
+            firstFree = base + lowestBit(free);
+        }
+        if (bytes.match(bucket_detail::ESS) != 0) {
+            HT_RECORD_PROBES(step + 1);
+            return firstFree;
+        }
+        group = (group + step + 1) & groupMask;
+    }
+
+    HT_RECORD_PROBES(groupMask + 1);
+    return firstFree;
+}
+
+/* Group probing version of findFreeIndex - first free bucket in the first group that has one
+ */
+HT_TEMPLATE
+size_t HT_CLASS::findFreeIndexGrouped(size_t hash) const {
+    using namespace probe_detail;
+    const size_t groupMask = tableData.control.size() / ControlGroup::WIDTH - 1;
+    size_t group = homeIndex(tableData, hash) / ControlGroup::WIDTH;
+
+    for (size_t step = 0; step <= groupMask; step++) {
+        size_t base = group * ControlGroup::WIDTH;
+        uint32_t free = ControlGroup(tableData.control.data() + base).matchFree();
+        if (free != 0) {
+            return base + lowestBit(free);
+        }
+        group = (group + step + 1) & groupMask;
+    }
+    return tableData.capacity();  // Unreachable while the load factor stays below 1
+}
+
+/* Robin Hood lookup - a linear walk that also stops at the first entry closer to its home than the
+key would be at that step: had the key been inserted, it would have taken that entry's bucket.
+Only entries exactly as far from home as the key (the ones sharing its home bucket) are compared.
+EAR buckets only occur in the old array of an incremental resize and are walked past
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findKeyIndexRobinHood(const Storage& table, const KeyLike& key, size_t hash) const {
+    typename Probe::Sequence probe(homeIndex(table, hash), table.mask);
+    for (size_t distance = 0; distance <= table.mask; distance++, probe.next()) {
+        size_t index = probe.index();
+        uint8_t state = table.control[index];
+        if (state == bucket_detail::ESS) {
+            HT_RECORD_PROBES(distance + 1);
+            return table.capacity();
+        }
+        if (state == bucket_detail::EAR) continue;
+
+        size_t resident = distanceAt(table, index);
+        if (resident < distance) {
+            HT_RECORD_PROBES(distance + 1);
+            return table.capacity();  // The key would have displaced this entry
+        }
+        if (resident == distance && bucketMatches(table, index, hash, key)) {
+            HT_RECORD_PROBES(distance + 1);
+            return index;
+        }
+    }
+    HT_RECORD_PROBES(table.mask + 1);
+    return table.capacity();
+}
+
+/* Robin Hood insert walk - the key's bucket (found = true), or the bucket a new entry takes:
+the first ESS bucket or the first entry closer to its home than the key, which occupy() moves on
+ */
+HT_TEMPLATE
+template<typename KeyLike>
+size_t HT_CLASS::findInsertIndexRobinHood(const KeyLike& key, size_t hash, bool& found) const {
+    typename Probe::Sequence probe(homeIndex(tableData, hash), tableData.mask);
+    found = false;
+    for (size_t distance = 0; distance <= tableData.mask; distance++, probe.next()) {
+        size_t index = probe.index();
+        uint8_t state = tableData.control[index];
+        if (state == bucket_detail::ESS) {
+            HT_RECORD_PROBES(distance + 1);
+            return index;
+        }
+        size_t resident = distanceAt(tableData, index);
+        if (resident < distance) {
+            HT_RECORD_PROBES(distance + 1);
+            return index;
+        }
+        if (resident == distance && bucketMatches(tableData, index, hash, key)) {
+            HT_RECORD_PROBES(distance + 1);
+            found = true;
+            return index;
+        }
+    }
+    HT_RECORD_PROBES(tableData.mask + 1);
+    return tableData.capacity();
+}
+
+// Robin Hood bucket for an entry known to be absent (rehash, migration): findInsertIndexRobinHood without keys
+
+HT_TEMPLATE
+size_t HT_CLASS::findFreeIndexRobinHood(size_t hash) const {
+    typename Probe::Sequence probe(homeIndex(tableData, hash), tableData.mask);
+    for (size_t distance = 0; distance <= tableData.mask; distance++, probe.next()) {
+        size_t index = probe.index();
+        uint8_t state = tableData.control[index];
+        if (state == bucket_detail::ESS) return index;
+        size_t resident = distanceAt(tableData, index);
+        if (resident < distance) return index;
+    }
+    return tableData.capacity();  // Unreachable while the load factor stays below 1
+}
+
+/* Distance of bucket `index`'s entry from its home bucket
+Read from the control byte, or recomputed from the entry's hash when it is too large for one
+ */
+HT_TEMPLATE
+size_t HT_CLASS::distanceAt(const Storage& table, size_t index) const {
+    size_t stored = RobinHoodProbing::storedDistance(table.control[index]);
+    if (stored < RobinHoodProbing::MAX_STORED_DISTANCE) return stored;
+    return (index - homeIndex(table, bucketHash(table.buckets[index]))) & table.mask;
+}
+
+/* Make bucket `index` free for a poorer new entry: carry its entry one bucket on, and keep going -
+wherever the carried entry is farther from home than the resident, the two swap and the resident
+is carried on instead - until the carried entry reaches an ESS bucket
+ */
+HT_TEMPLATE
+void HT_CLASS::makeRoom(size_t index) {
+    if (tableData.control[index] == bucket_detail::ESS) return;
+    size_t carriedDistance = distanceAt(tableData, index);
+    uint8_t carriedControl = tableData.control[index];
+    Bucket carried = std::move(tableData.buckets[index]);
+
+    for (size_t next = (index + 1) & tableData.mask;; next = (next + 1) & tableData.mask) {
+        carriedDistance++;
+        uint8_t state = tableData.control[next];
+        if (state == bucket_detail::ESS) {
+            tableData.buckets[next] = std::move(carried);
+            tableData.control[next] = RobinHoodProbing::withDistance(carriedControl, carriedDistance);
+            return;
+        }
+        size_t resident = distanceAt(tableData, next);
+        if (resident < carriedDistance) {
+            std::swap(tableData.buckets[next], carried);
+            tableData.control[next] = RobinHoodProbing::withDistance(carriedControl, carriedDistance);
+            carriedControl = state;
+            carriedDistance = resident;
+        }
+    }
+}
+
+/*Insert a key-value pair into the hash table
+Uses a single probe walk to both reject duplicates and find the slot to fill
+(plus a lookup in the old array while an incremental resize is running)
+@return: true if inserted successfully, false if key already exists
+ */
+HT_TEMPLATE
+bool HT_CLASS::insert(K key, V value) {
+    // First check if we need to resize the table
+    resizeIfNeeded();
+    if (isMigrating()) migrateBuckets(migrateStep());
+
+    bool found;
+    size_t hash = hashFunction(key);
+    size_t index = findInsertIndex(key, hash, found);
+
+    if (found || index == tableData.capacity()) {
+        return false;  // Insertion failed - key already exists (or no free bucket)
+    }
+    if (isMigrating() && findKeyIndex(oldTable, key, hash) < oldTable.capacity()) {
+        return false;  // Key exists in the part of the table not yet migrated
+    }
+
+    occupy(index, hash);  // Mark NORMAL (reusing a removed slot, or making room for a Robin Hood entry)
+    tableData.buckets[index].load(storeKey(std::move(key)), std::move(value), hash);  // Move the key into the chosen bucket
+    numItems++;  // Increase count of stored items
+    return true;  // Successfully inserted
+}
+
+/*Insert a key-value pair given only a view of the key (or any key_arg type)
+The stored key is built from it only once we know the key is new,
+so a rejected duplicate costs no allocation at all
+@return: true if inserted successfully, false if key already exists
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+bool HT_CLASS::emplace(const key_arg<KeyArg>& key, V value) {
+    return findOrInsert(key, std::move(value)).second;
+}
+
+/*Remove a key-value pair from the hash table
+@return: true if removed successfully, false if key not found
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+bool HT_CLASS::remove(const key_arg<KeyArg>& key) {
+    if (isMigrating()) migrateBuckets(migrateStep());
+
+    // Find the key using our search helper
+    Position position = locate(key);
+
+    // If key was found
+    if (position.found()) {
+        erase(position.inOld ? oldTable : tableData, position.index);
+        numItems--;  // Decrease count of stored items
+        shrinkIfSparse();
+        compactKeyArena();
+        return true;  // Successfully removed
+    }
+
+    return false;  // Key not found
+}
+
+//Check if a key exists in the hash table
+
+HT_TEMPLATE
+template<typename KeyArg>
+bool HT_CLASS::contains(const key_arg<KeyArg>& key) const {
+    // Uses locate helper - if it finds a bucket, key exists
+    return locate(key).found();
+}
+
+//Get the value associated with a key
+
+HT_TEMPLATE
+template<typename KeyArg>
+optional<V> HT_CLASS::get(const key_arg<KeyArg>& key) const {
+    // Find the key
+    Position position = locate(key);
+
+    // If key was found, return its value wrapped in optional
+    if (position.found()) {
+        return (position.inOld ? oldTable : tableData).buckets[position.index].getValue();
+    }
+    // Key not found - return empty optional
+    return nullopt;
+}
+
+//Find the stored value for a key - nullptr if the key is not in the table
+
+HT_TEMPLATE
+template<typename KeyArg>
+V* HT_CLASS::find(const key_arg<KeyArg>& key) {
+    Position position = locate(key);
+    if (!position.found()) return nullptr;
+    return &(position.inOld ? oldTable : tableData).buckets[position.index].getValueRef();
+}
+
+HT_TEMPLATE
+template<typename KeyArg>
+const V* HT_CLASS::find(const key_arg<KeyArg>& key) const {
+    Position position = locate(key);
+    if (!position.found()) return nullptr;
+    return &(position.inOld ? oldTable : tableData).buckets[position.index].getValueRef();
+}
+
+/*Shared by operator[], try_emplace, insert_or_assign and emplace - one hash and one probe walk
+The walk either meets the key or ends at the bucket a new entry goes to; only then (and only for a
+new key) is the stored key built and the value constructed from args. While an incremental resize
+runs, a key not in the new array is also looked up in the old one
+@return: pointer to the key's value, and true if the key was inserted
+ */
+HT_TEMPLATE
+template<typename KeyLike, typename... Args>
+pair<V*, bool> HT_CLASS::findOrInsert(const KeyLike& key, Args&&... args) {
+    resizeIfNeeded();
+    if (isMigrating()) migrateBuckets(migrateStep());
+
+    bool found;
+    size_t hash = hashFunction(key);
+    size_t index = findInsertIndex(key, hash, found);
+
+    if (found) {
+        return {&tableData.buckets[index].getValueRef(), false};
+    }
+    if (isMigrating()) {
+        size_t oldIndex = findKeyIndex(oldTable, key, hash);
+        if (oldIndex < oldTable.capacity()) return {&oldTable.buckets[oldIndex].getValueRef(), false};
+    }
+    if (index == tableData.capacity()) {
+        // The walk met no free bucket, which the load factor limit should rule out: grow instead of failing
+        rehash(tableData.capacity() * 2);
+        index = findInsertIndex(key, hash, found);
+    }
+
+    occupy(index, hash);
+    tableData.buckets[index].load(storeKey(key), V(std::forward<Args>(args)...), hash);
+    numItems++;
+    return {&tableData.buckets[index].getValueRef(), true};
+}
+
+/*Array-style access operator - allows both reading and writing values
+A missing key is inserted with V() in the same probe walk that looked for it, so `ht[key]++`
+costs one lookup and builds the stored key only for a new key
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+V& HT_CLASS::operator[](const key_arg<KeyArg>& key) {
+    return *findOrInsert(key).first;
+}
+
+/*Insert key with a value constructed from args, unless the key is already stored
+args are left untouched when the key exists (an rvalue passed in is not moved from)
+@return: pointer to the stored value, and true if the key was inserted
+ */
+HT_TEMPLATE
+template<typename KeyArg, typename... Args>
+pair<V*, bool> HT_CLASS::try_emplace(const key_arg<KeyArg>& key, Args&&... args) {
+    return findOrInsert(key, std::forward<Args>(args)...);
+}
+
+/*Insert a key-value pair, or overwrite the value of a key already stored (one probe walk)
+@return: true if the key was inserted, false if its value was assigned
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+bool HT_CLASS::insert_or_assign(const key_arg<KeyArg>& key, V value) {
+    auto [stored, inserted] = findOrInsert(key, std::move(value));
+    if (!inserted) *stored = std::move(value);
+    return inserted;
+}
+
+/*Resolve a batch of lookups LOOKUP_BATCH keys at a time, calling visit(i, position) for each key
+Each chunk goes through three passes: hash every key, prefetch the control byte and bucket of every
+home index, then walk each probe sequence - by the time a walk starts, its first cache lines are on
+their way or already loaded. Only the current array is prefetched; while an incremental resize is
+running, keys still in the old array are found there without a prefetch
+@return: number of keys found
+ */
+HT_TEMPLATE
+template<typename KeyLike, typename Visit>
+size_t HT_CLASS::lookupBatch(span<const KeyLike> keys, Visit visit) const {
+    size_t hashes[LOOKUP_BATCH];
+    size_t hits = 0;
+
+    for (size_t start = 0; start < keys.size(); start += LOOKUP_BATCH) {
+        size_t count = std::min(LOOKUP_BATCH, keys.size() - start);
+        for (size_t i = 0; i < count; i++) {
+            hashes[i] = hashFunction(keys[start + i]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t home = homeIndex(tableData, hashes[i]);
+            probe_detail::prefetch(&tableData.control[home]);
+            probe_detail::prefetch(&tableData.buckets[home]);
+        }
+        for (size_t i = 0; i < count; i++) {
+            Position position = locate(keys[start + i], hashes[i]);
+            if (position.found()) hits++;
+            visit(start + i, position);
+        }
+    }
+    return hits;
+}
+
+/*Look up a batch of keys: out[i] = get(keys[i])
+@return: number of keys found
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+size_t HT_CLASS::get_many(span<const key_arg<KeyArg>> keys, span<optional<V>> out) const {
+    if (out.size() < keys.size()) {
+        throw invalid_argument("get_many: out is shorter than keys");
+    }
+    return lookupBatch(keys, [&](size_t i, const Position& position) {
+        if (position.found()) {
+            out[i] = (position.inOld ? oldTable : tableData).buckets[position.index].getValue();
+        } else {
+            out[i] = nullopt;
+        }
+    });
+}
+
+/*Check a batch of keys: out[i] = contains(keys[i])
+@return: number of keys found
+ */
+HT_TEMPLATE
+template<typename KeyArg>
+size_t HT_CLASS::contains_many(span<const key_arg<KeyArg>> keys, span<bool> out) const {
+    if (out.size() < keys.size()) {
+        throw invalid_argument("contains_many: out is shorter than keys");
+    }
+    return lookupBatch(keys, [&](size_t i, const Position& position) { out[i] = position.found(); });
+}
+
+/*Get all keys currently stored in the hash table (both generations during an incremental resize)
+Useful for iteration and debugging
+ */
+HT_TEMPLATE
+vector<K> HT_CLASS::keys() const {
+    vector<K> keyList;  // Create empty vector to store keys
+    keyList.reserve(numItems);
+
+    // Iterate through all buckets in the table
+    for (const Storage* table : {&tableData, &oldTable}) {
+        for (size_t i = 0; i < table->capacity(); i++) {
+            // Only add keys from buckets that have valid data
+            if (bucket_detail::isNormal(table->control[i])) {
+                keyList.emplace_back(keyOf(table->buckets[i]));
+            }
+        }
+    }
+
+    return keyList;  // Return complete list of keys
+}
+
+/*Visit every entry without copying any key: fn(const K&, const V&) is called once per entry
+(the table must not be changed from inside fn). With inline string keys fn gets a string_view when it
+accepts one, and otherwise a string built from it
+ */
+HT_TEMPLATE
+template<typename Fn>
+void HT_CLASS::for_each(Fn fn) const {
+    for (const Storage* table : {&tableData, &oldTable}) {
+        for (size_t i = 0; i < table->capacity(); i++) {
+            if (bucket_detail::isNormal(table->control[i])) {
+                const Bucket& bucket = table->buckets[i];
+                if constexpr (!INLINE_KEYS || is_invocable_v<Fn&, string_view, const V&>) {
+                    fn(keyOf(bucket), bucket.getValue());
+                } else {
+                    fn(K(keyOf(bucket)), bucket.getValue());
+                }
+            }
+        }
+    }
+}
+
+/*Calculate current load factor of the hash table
+Load factor = number of items / total buckets
+ */
+HT_TEMPLATE
+double HT_CLASS::alpha() const {
+    // Handle edge case of empty table
+    if (tableData.capacity() == 0) return 0.0;
+
+    // Use static_cast to ensure floating-point division
+    return static_cast<double>(numItems) / static_cast<double>(tableData.capacity());
+}
+
+//Get total number of buckets in the hash table (capacity)
+HT_TEMPLATE
+size_t HT_CLASS::capacity() const {
+    return tableData.capacity();
+}
+
+//Get number of key-value pairs currently stored in the table
+
+HT_TEMPLATE
+size_t HT_CLASS::size() const {
+    return numItems;
+}
+
+//Get number of EAR buckets in the table - removed entries that probes still have to walk past
+
+HT_TEMPLATE
+size_t HT_CLASS::tombstoneCount() const {
+    return tableData.tombstones;
+}
+
+/*Remove every tombstone now, without allocating, e.g. after a burst of removals
+Misses stop at the first ESS bucket again instead of walking past removed entries
+ */
+HT_TEMPLATE
+void HT_CLASS::compact() {
+    rehashInPlace();
+}
+
+//Get the load (live entries plus tombstones per bucket) at which the table resizes
+
+HT_TEMPLATE
+double HT_CLASS::max_load_factor() const {
+    return maxLoad;
+}
+
+/*Set the resize threshold - e.g. 0.875 to keep buckets mostly full and save memory
+Grows the table right away if it is already above the new threshold. Unlike reserve(), this leaves
+the auto-shrink floor alone, so the table still shrinks once entries are removed
+ */
+HT_TEMPLATE
+void HT_CLASS::max_load_factor(double load) {
+    if (!(load > 0.0 && load <= MAX_MAX_LOAD_FACTOR)) {
+        throw invalid_argument("max_load_factor must be in (0, 0.95]");
+    }
+    maxLoad = load;
+    size_t target = capacityFor(numItems);
+    if (target > tableData.capacity()) {
+        rehash(target);
+    }
+}
+
+/*Make room for `count` entries: after this, inserting up to count entries in total never resizes
+Never shrinks; the reserved capacity also becomes the floor for auto-shrinking
+ */
+HT_TEMPLATE
+void HT_CLASS::reserve(size_t count) {
+    size_t target = capacityFor(count);
+    minCapacity = std::max(minCapacity, target);
+    if (target > tableData.capacity()) {
+        rehash(target);
+    }
+}
+
+/*Shrink to the smallest capacity that holds the current entries within max_load_factor()
+Also drops every tombstone, and resets the auto-shrink floor to the new capacity
+ */
+HT_TEMPLATE
+void HT_CLASS::shrink_to_fit() {
+    size_t target = capacityFor(numItems);
+    minCapacity = target;
+    if (target < tableData.capacity()) {
+        rehash(target);
+    } else {
+        rehashInPlace();
+    }
+}
+
+/*Insert a batch of entries - the shared body of both insert_bulk() overloads
+1. Every key is hashed first, in a loop with no dependence between iterations, so the compiler can
+   unroll it and the CPU overlaps the hash computations instead of interleaving them with probe walks
+2. The table is sized once, for the case where every key is new, and left without tombstones
+3. Each entry is placed with one probe walk; a key already present is handled according to `policy`
+With THROW nothing is moved out of the batch, and the entries placed before the duplicate are taken
+out again before throwing, so the table holds exactly what it held before (its capacity may have grown)
+@return: number of new keys inserted
+ */
+HT_TEMPLATE
+template<typename Entries>
+size_t HT_CLASS::insertBulk(Entries& entries, bool moveEntries, DuplicatePolicy policy) {
+    size_t count = entries.size();
+    if (count == 0) return 0;
+
+    vector<size_t> hashes(count);
+    for (size_t i = 0; i < count; i++) {
+        hashes[i] = hashFunction(entries[i].first);
+    }
+
+    finishMigration();
+    size_t target = capacityFor(numItems + count);
+    if (target > tableData.capacity()) {
+        rehash(target);
+    } else if (tableData.tombstones > 0) {
+        rehashInPlace();
+    }
+
+    // Every free bucket is ESS from here on, so undoing a placement just marks it ESS again.
+    // Robin Hood placements move earlier entries, so there the batch positions are kept and the
+    // keys removed again one by one instead
+    bool undoable = policy == DuplicatePolicy::THROW;
+    if (undoable) moveEntries = false;
+    vector<size_t> placed;  // Buckets filled by this call, or batch positions placed (THROW only)
+    size_t inserted = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (i + BULK_PREFETCH_DISTANCE < count) {
+            size_t ahead = homeIndex(tableData, hashes[i + BULK_PREFETCH_DISTANCE]);
+            probe_detail::prefetch(&tableData.control[ahead]);
+            probe_detail::prefetch(&tableData.buckets[ahead]);
+        }
+        auto& entry = entries[i];
+        bool found;
+        size_t index = findInsertIndex(entry.first, hashes[i], found);
+
+        if (found) {
+            if (policy == DuplicatePolicy::LAST_WINS) {
+                if (moveEntries) tableData.buckets[index].setValue(std::move(entry.second));
+                else tableData.buckets[index].setValue(entry.second);
+            } else if (undoable) {
+                for (size_t undo : placed) {
+                    if constexpr (Probe::ROBIN_HOOD) {
+                        erase(tableData, findKeyIndex(tableData, entries[undo].first, hashes[undo]));
+                    } else {
+                        releaseKey(tableData.buckets[undo]);
+                        tableData.control[undo] = bucket_detail::ESS;
+                        tableData.buckets[undo].clear();
+                    }
+                }
+                numItems -= inserted;
+                throw invalid_argument("insert_bulk: duplicate key");
+            }
+            continue;  // FIRST_WINS: keep the stored value
+        }
+
+        occupy(index, hashes[i]);
+        if (moveEntries) tableData.buckets[index].load(storeKey(std::move(entry.first)), std::move(entry.second), hashes[i]);
+        else tableData.buckets[index].load(storeKey(entry.first), entry.second, hashes[i]);
+        if (undoable) placed.push_back(Probe::ROBIN_HOOD ? i : index);
+        numItems++;
+        inserted++;
+    }
+    return inserted;
+}
+
+/*Insert a batch of entries, copying them in (see insertBulk for how the batch is placed)
+Duplicates - against the table or earlier in the batch - follow `policy`
+@return: number of new keys inserted
+ */
+HT_TEMPLATE
+size_t HT_CLASS::insert_bulk(span<const pair<K, V>> entries, DuplicatePolicy policy) {
+    return insertBulk(entries, false, policy);
+}
+
+/*Insert a batch of entries, moving keys and values out of `entries`
+Their contents are unspecified afterwards, except with THROW, which copies so a failed call changes nothing
+@return: number of new keys inserted
+ */
+HT_TEMPLATE
+size_t HT_CLASS::insert_bulk(vector<pair<K, V>>&& entries, DuplicatePolicy policy) {
+    return insertBulk(entries, true, policy);
+}
+
+/*Build a new table from any range of key/value pairs with one insert_bulk() call
+An rvalue vector<pair<K, V>> is moved from, contiguous pairs are copied straight in,
+anything else (a map, pairs of string_view and int, ...) is first converted into a vector
+@return: the new table, sized for the range
+ */
+HT_TEMPLATE
+template<typename Range>
+HT_CLASS HT_CLASS::from_range(Range&& range, DuplicatePolicy policy) {
+    BasicHashTable table;
+    if constexpr (is_same_v<remove_cvref_t<Range>, vector<pair<K, V>>> && !is_lvalue_reference_v<Range>) {
+        table.insert_bulk(std::move(range), policy);
+    } else if constexpr (is_convertible_v<Range&, span<const pair<K, V>>>) {
+        table.insert_bulk(span<const pair<K, V>>(range), policy);
+    } else {
+        vector<pair<K, V>> entries;
+        if constexpr (ranges::sized_range<Range>) entries.reserve(ranges::size(range));
+        for (auto&& [key, value] : range) entries.emplace_back(K(key), V(value));
+        table.insert_bulk(std::move(entries), policy);
+    }
+    return table;
+}
+
+/*Turn incremental resizing on or off
+Turning it off finishes any migration in progress, so the table is back to a single array
+ */
+HT_TEMPLATE
+void HT_CLASS::setIncrementalResize(bool enabled) {
+    incremental = enabled;
+    if (!enabled) finishMigration();
+}
+
+//Is incremental resizing on
+
+HT_TEMPLATE
+bool HT_CLASS::incrementalResize() const {
+    return incremental;
+}
+
+//Is an incremental resize still moving entries out of the old array
+
+HT_TEMPLATE
+bool HT_CLASS::isMigrating() const {
+    return oldTable.capacity() != 0;
+}
+
+/*Fraction of the old array's buckets already migrated
+@return: 0.0 right after a resize starts, 1.0 when no migration is running
+ */
+HT_TEMPLATE
+double HT_CLASS::migrationProgress() const {
+    if (!isMigrating()) return 1.0;
+    return static_cast<double>(migrated) / static_cast<double>(oldTable.capacity());
+}
+
+//Move every remaining old entry now, e.g. at a quiet moment or before a latency-critical phase
+
+HT_TEMPLATE
+void HT_CLASS::finishMigration() {
+    if (isMigrating()) migrateBuckets(oldTable.capacity());
+}
+
+//Set the number of workers a rehash of PARALLEL_REHASH_MIN or more entries uses
+
+HT_TEMPLATE
+void HT_CLASS::setRehashThreads(size_t threads) {
+    rehashThreads = threads;
+}
+
+//Workers a large rehash would use: the configured count, or one per hardware thread
+
+HT_TEMPLATE
+size_t HT_CLASS::rehashThreadCount() const {
+    return rehashThreads != 0 ? rehashThreads : std::max<size_t>(1, thread::hardware_concurrency());
+}
+
+#ifdef HASHTABLE_STATS
+/*Record one probe walk that inspected `count` buckets
+Only compiled into the benchmark build
+ */
+HT_TEMPLATE
+void HT_CLASS::recordProbes(size_t count) const {
+    stats.walks++;
+    stats.probes += count;
+    if (count > stats.maxProbes) stats.maxProbes = count;
+}
+
+//Probe counters collected since construction or the last reset
+HT_TEMPLATE
+const ProbeStats& HT_CLASS::probeStats() const {
+    return stats;
+}
+
+//Zero the probe counters, e.g. between benchmark phases
+HT_TEMPLATE
+void HT_CLASS::resetProbeStats() {
+    stats = ProbeStats();
+}
+#endif
+
+/*Output operator for entire hash table - prints all occupied buckets
+Only prints buckets that contain data, shows bucket indices
+(entries not yet moved by an incremental resize are listed as old buckets)
+ */
+template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, typename Probe>
+ostream& operator<<(ostream& os, const BasicHashTable<K, V, Hash, KeyEqual, Alloc, Probe>& hashTable) {
+    bool foundItems = false;  // Track if  found any items to print
+
+    // Iterate through all buckets in the table
+    for (const auto* table : {&hashTable.tableData, &hashTable.oldTable}) {
+        for (size_t i = 0; i < table->capacity(); i++) {
+            const auto& bucket = table->buckets[i];
+
+            // Only print buckets that have valid data
+            if (bucket_detail::isNormal(table->control[i])) {
+                os << (table == &hashTable.oldTable ? "Old bucket " : "Bucket ") << i << ": <" << hashTable.keyOf(bucket)
+                   << ", " << bucket.getValue() << ">" << endl;
+                foundItems = true;  // Mark found at least one item
+            }
+        }
+    }
+
+    // If no items found, print empty message
+    if (!foundItems) {
+        os << "Table is empty" << endl;
+    }
+
+    return os;
+}
+
+#undef HT_RECORD_PROBES
+#undef HT_BUCKET_TEMPLATE
+#undef HT_BUCKET
+#undef HT_TEMPLATE
+#undef HT_CLASS
+
+#endif
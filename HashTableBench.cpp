@@ -0,0 +1,877 @@
+/*
+HashTableBench.cpp
+Benchmark driver for the HashTable hot paths: insert, get, contains, remove and operator[],
+plus get-many (get_many() over batches of GET_MANY_BATCH hit keys) and insert-bulk
+(one insert_bulk() call loading the whole key set into a fresh table).
+
+Every workload builds a key set, fills a fresh table and times each map operation, reporting
+throughput (ops/sec), latency percentiles (p50/p99/p999), heap bytes per entry and probe counts.
+The target is compiled with HASHTABLE_STATS so the table counts the buckets it inspects.
+
+Workloads:
+  uniform     - random 8..24 character keys, lookups spread uniformly over the key set
+  zipf        - the same keys, lookups follow a Zipfian(0.99) popularity curve
+  sequential  - to_string(i) keys like the test harness uses, uniform lookups
+  adversarial - "Aa"/"BB" block keys that all share one polynomial hash value
+                (capped by --adversarial-max because every probe walk is O(n) for them
+                under PolynomialHash)
+
+Tables (--tables, default HashTable; "all" runs every configuration):
+  HashTable   - the default configuration (WyHash)
+  Polynomial  - BasicHashTable<string, int, PolynomialHash>, the original hash * 31 + c
+  Stripe      - BasicHashTable<string, int, StripeHash>, SIMD hashing for long keys
+  Group       - GroupHashTable<>, SIMD control-byte group probing
+  Linear      - ProbingHashTable<LinearProbing>
+  Triangular  - ProbingHashTable<TriangularProbing>
+  RobinHood   - RobinHoodHashTable<>, Robin Hood insertion and backward-shift removal
+  Cuckoo      - CuckooHashTable<>, two buckets of 4 slots per key (probes = buckets read)
+  HugePage    - HugePageHashTable<>, arrays mapped on transparent huge pages (compare get at 10M+)
+  Incremental - HashTable with incremental resizing (compare insert p999)
+
+Usage:
+  HashTableBench [--min-size N] [--max-size N] [--ops N] [--workloads a,b,...]
+                 [--tables a,b,...] [--hash-lengths n,m,...]
+                 [--adversarial-max N] [--max-load X] [--threads n,m,...]
+                 [--save FILE] [--compare FILE] [--tolerance PCT]
+
+  Sizes run from --min-size (default 1K) up to --max-size (default 1M) in steps of 10x;
+  pass --max-size 100000000 for the full 100M sweep. --save writes the results as a CSV
+  baseline and --compare checks this run against one, exiting with status 1 when any
+  throughput drops (or p99 latency rises) by more than --tolerance percent (default 10).
+  --hash-lengths also measures raw hashing speed (GB/s) of every hash policy per key length.
+  --max-load sets max_load_factor() on every table (e.g. 0.875) to compare probing at high load.
+  --threads 1,2,4,... runs the multi-threaded comparison below with each thread count.
+
+Multi-threaded throughput (--threads): every thread runs the same mix of get and
+insert_or_assign against one table prefilled with --max-size keys, --ops operations per thread:
+  Mutex       - HashTable behind a single std::mutex
+  Concurrent  - ConcurrentHashTable (lock striping over bucket regions)
+  mixes: read-heavy (90% get) and write-heavy (50% get)
+then a counters mix where every operation is `ht[key]++` on an initially empty table:
+  Mutex       - HashTable::operator[] behind the mutex
+  Concurrent  - ConcurrentHashTable update(), inserting 0 first for a new key
+  Sharded     - ShardedHashTable upsert() (independent HashTable shards, one lock each)
+and, for a config-cache mix (99% get) over uint64_t keys:
+  Locked      - ConcurrentHashTable<uint64_t, int> with shared-locked reads (LockFreeReads = false)
+  LockFree    - ConcurrentHashTable<uint64_t, int>, whose reads take no lock
+The same thread counts then time one doubling rehash (the resize pause) of a HashTable holding
+max(--max-size, PARALLEL_REHASH_MIN) keys, moved by that many workers (setRehashThreads()).
+
+Build with optimizations (e.g. -DCMAKE_BUILD_TYPE=Release) for meaningful numbers.
+ */
+
+#include "HashTable.h"
+#include "ConcurrentHashTable.h"
+#include "ShardedHashTable.h"
+#include "CuckooHashTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+using namespace std;
+
+// HEAP ACCOUNTING
+/*
+Replacing the global allocation functions lets the benchmark measure exactly how many heap
+bytes a table owns (control bytes, bucket array and out-of-line key storage) without any
+hooks inside HashTable. Every block carries a small header recording its size (a whole alignment
+unit for over-aligned blocks). Arrays HugePageAllocator maps itself are counted by the allocator
+and added in tableBytes().
+ */
+static atomic<size_t> liveHeapBytes{0};
+static constexpr size_t HEAP_HEADER = alignof(max_align_t);
+
+void* operator new(size_t size) {
+    void* block = malloc(size + HEAP_HEADER);
+    if (!block) throw bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    liveHeapBytes += size;
+    return static_cast<char*>(block) + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    void* block = static_cast<char*>(ptr) - HEAP_HEADER;
+    liveHeapBytes -= *static_cast<size_t*>(block);
+    free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+void* operator new(size_t size, align_val_t align) {
+    size_t header = max(static_cast<size_t>(align), HEAP_HEADER);
+    void* block = aligned_alloc(header, (size + 2 * header - 1) / header * header);
+    if (!block) throw bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    liveHeapBytes += size;
+    return static_cast<char*>(block) + header;
+}
+
+void operator delete(void* ptr, align_val_t align) noexcept {
+    if (!ptr) return;
+    void* block = static_cast<char*>(ptr) - max(static_cast<size_t>(align), HEAP_HEADER);
+    liveHeapBytes -= *static_cast<size_t*>(block);
+    free(block);
+}
+
+void* operator new[](size_t size, align_val_t align) { return operator new(size, align); }
+void operator delete[](void* ptr, align_val_t align) noexcept { operator delete(ptr, align); }
+void operator delete(void* ptr, size_t, align_val_t align) noexcept { operator delete(ptr, align); }
+void operator delete[](void* ptr, size_t, align_val_t align) noexcept { operator delete(ptr, align); }
+
+// Heap bytes plus the arrays mapped directly by HugePageAllocator
+static size_t tableBytes() {
+    return liveHeapBytes + hugepage_detail::mappedBytes;
+}
+
+// BENCHMARK CONFIGURATION AND RESULTS
+
+struct BenchConfig {
+    size_t minSize = 1000;              // Smallest table size in the sweep
+    size_t maxSize = 1000000;           // Largest table size in the sweep
+    size_t lookupOps = 1000000;         // Operations per get/contains/operator[] phase
+    size_t adversarialMax = 4096;       // Cap on colliding keys (probe walks are O(n))
+    vector<string> workloads = {"uniform", "zipf", "sequential", "adversarial"};
+    vector<string> tables = {"HashTable"};
+    vector<size_t> hashLengths;         // Key lengths for the raw hash comparison (empty = skip)
+    string saveFile;                    // CSV baseline to write
+    string compareFile;                 // CSV baseline to compare against
+    double tolerance = 10.0;            // Allowed regression in percent
+    double maxLoad = 0.0;               // max_load_factor() for every table (0 = table default)
+    vector<size_t> threads;             // Thread counts for the multi-threaded comparison (empty = skip)
+};
+
+// One row of output: a single operation type measured on one table/workload/size
+struct BenchResult {
+    string table;
+    string workload;
+    size_t size = 0;
+    string op;
+    double opsPerSec = 0;
+    double p50 = 0, p99 = 0, p999 = 0;  // Latency percentiles in nanoseconds
+    double bytesPerEntry = 0;
+    double avgProbes = 0;
+    size_t maxProbes = 0;
+};
+
+// KEY SETS AND ACCESS PATTERNS
+
+// Random printable key with a length between 8 and 24 characters
+static string randomKey(mt19937_64& rng) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789/-_.";
+    size_t length = 8 + rng() % 17;
+    string key(length, ' ');
+    for (char& c : key) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+    return key;
+}
+
+/*
+Colliding key number `index`: each of the `blocks` two-character blocks is "Aa" or "BB"
+depending on one bit of the index. Both blocks hash to 2112 under hash * 31 + c, so every
+key of the same length has an identical polynomial hash.
+ */
+static string collidingKey(size_t index, size_t blocks) {
+    string key;
+    key.reserve(blocks * 2);
+    for (size_t b = 0; b < blocks; b++) {
+        key += ((index >> b) & 1) ? "BB" : "Aa";
+    }
+    return key;
+}
+
+/*
+Build `count` keys for a workload. `missSet` selects a disjoint set of keys used to
+measure unsuccessful lookups.
+ */
+static vector<string> makeKeys(const string& workload, size_t count, bool missSet) {
+    vector<string> keys;
+    keys.reserve(count);
+    if (workload == "sequential") {
+        size_t first = missSet ? count + 1 : 1;
+        for (size_t i = 0; i < count; i++) keys.push_back(to_string(first + i));
+    } else if (workload == "adversarial") {
+        size_t blocks = 1;
+        while ((size_t(1) << blocks) < 2 * count) blocks++;
+        size_t first = missSet ? count : 0;
+        for (size_t i = 0; i < count; i++) keys.push_back(collidingKey(first + i, blocks));
+    } else {
+        mt19937_64 rng(missSet ? 0xBADC0FFEEULL : 0x5EED5EEDULL);
+        for (size_t i = 0; i < count; i++) keys.push_back(randomKey(rng));
+    }
+    return keys;
+}
+
+/*
+Zipfian rank generator (Gray et al., "Quickly Generating Billion-Record Synthetic
+Databases"), the same construction YCSB uses. Rank 0 is the most popular key.
+ */
+class ZipfGenerator {
+private:
+    size_t n;
+    double theta, alpha, zetan, eta;
+    uniform_real_distribution<double> uniform{0.0, 1.0};
+
+public:
+    ZipfGenerator(size_t n, double theta) : n(n), theta(theta) {
+        zetan = 0;
+        for (size_t i = 1; i <= n; i++) zetan += 1.0 / pow(static_cast<double>(i), theta);
+        double zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    size_t next(mt19937_64& rng) {
+        double u = uniform(rng);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + pow(0.5, theta)) return 1;
+        size_t rank = static_cast<size_t>(static_cast<double>(n) * pow(eta * u - eta + 1.0, alpha));
+        return min(rank, n - 1);
+    }
+};
+
+// Indices into the key set for one lookup phase, drawn from the workload's distribution
+static vector<size_t> makeAccessPattern(const string& workload, size_t keyCount, size_t ops, uint64_t seed) {
+    vector<size_t> pattern(ops);
+    mt19937_64 rng(seed);
+    if (workload == "zipf") {
+        ZipfGenerator zipf(keyCount, 0.99);
+        for (size_t& index : pattern) index = zipf.next(rng);
+    } else {
+        for (size_t& index : pattern) index = rng() % keyCount;
+    }
+    return pattern;
+}
+
+// TIMING
+
+using Clock = chrono::steady_clock;
+
+static double nanosBetween(Clock::time_point start, Clock::time_point end) {
+    return static_cast<double>(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+}
+
+// Cost of one back-to-back pair of clock reads, subtracted from sampled latencies
+static double timerOverhead() {
+    vector<double> samples(100000);
+    for (double& sample : samples) {
+        auto start = Clock::now();
+        auto end = Clock::now();
+        sample = nanosBetween(start, end);
+    }
+    nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+static const double TIMER_OVERHEAD = timerOverhead();
+
+/*
+Run `count` operations, timing every `stride`-th one individually so that at most ~100K
+latency samples are taken. Throughput is computed from the whole phase with the cost of
+the extra clock reads removed.
+ */
+template<typename Op>
+static void measurePhase(size_t count, Op op, BenchResult& result) {
+    size_t stride = max<size_t>(1, count / 100000);
+    vector<double> latencies;
+    latencies.reserve(count / stride + 1);
+
+    auto phaseStart = Clock::now();
+    for (size_t i = 0; i < count; i++) {
+        if (i % stride == 0) {
+            auto start = Clock::now();
+            op(i);
+            auto end = Clock::now();
+            latencies.push_back(max(0.0, nanosBetween(start, end) - TIMER_OVERHEAD));
+        } else {
+            op(i);
+        }
+    }
+    double elapsed = nanosBetween(phaseStart, Clock::now()) - TIMER_OVERHEAD * latencies.size();
+    result.opsPerSec = count / max(elapsed, 1.0) * 1e9;
+
+    auto percentile = [&latencies](double p) {
+        if (latencies.empty()) return 0.0;
+        size_t rank = min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()));
+        nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+        return latencies[rank];
+    };
+    result.p50 = percentile(0.50);
+    result.p99 = percentile(0.99);
+    result.p999 = percentile(0.999);
+}
+
+// Probe counters are only available on tables that expose them
+template<typename Table>
+static void resetProbes(Table& table) {
+    if constexpr (requires { table.resetProbeStats(); }) table.resetProbeStats();
+}
+
+template<typename Table>
+static void collectProbes(const Table& table, BenchResult& result) {
+    if constexpr (requires { table.probeStats(); }) {
+        const auto& stats = table.probeStats();
+        result.avgProbes = stats.walks ? static_cast<double>(stats.probes) / stats.walks : 0.0;
+        result.maxProbes = stats.maxProbes;
+    }
+}
+
+// WORKLOAD DRIVER
+
+static constexpr size_t GET_MANY_BATCH = 256;  // Keys per get_many() call (a typical request fan-out)
+
+/*
+Fill a fresh table with `size` keys and time every public operation against it.
+The table is passed by type so other table configurations can be compared side by side;
+Incremental turns on incremental resizing before the first insert.
+ */
+template<typename Table, bool Incremental = false>
+static void runWorkload(const string& tableName, const string& workload, size_t size,
+                        const BenchConfig& config, vector<BenchResult>& results) {
+    vector<string> keys = makeKeys(workload, size, false);
+    vector<string> missKeys = makeKeys(workload, size, true);
+    // Colliding keys make every lookup O(n), so their lookup phases are capped at n operations
+    size_t ops = workload == "adversarial" ? min(config.lookupOps, size) : config.lookupOps;
+    vector<size_t> hitPattern = makeAccessPattern(workload, size, ops, 1);
+    vector<size_t> missPattern = makeAccessPattern("uniform", size, ops, 2);
+
+    auto makeResult = [&](const string& op) {
+        BenchResult result;
+        result.table = tableName;
+        result.workload = workload;
+        result.size = size;
+        result.op = op;
+        return result;
+    };
+
+    size_t heapBefore = tableBytes();
+    Table table;
+    if constexpr (Incremental) table.setIncrementalResize(true);
+    if (config.maxLoad > 0) table.max_load_factor(config.maxLoad);
+    volatile long long sink = 0;  // Keeps lookups from being optimized away
+
+    BenchResult insertResult = makeResult("insert");
+    resetProbes(table);
+    measurePhase(size, [&](size_t i) { table.insert(keys[i], static_cast<int>(i)); }, insertResult);
+    collectProbes(table, insertResult);
+    double bytesPerEntry = static_cast<double>(tableBytes() - heapBefore) / max<size_t>(1, table.size());
+    results.push_back(insertResult);
+
+    BenchResult getHit = makeResult("get-hit");
+    resetProbes(table);
+    measurePhase(ops, [&](size_t i) { sink = sink + table.get(keys[hitPattern[i]]).value_or(0); }, getHit);
+    collectProbes(table, getHit);
+    results.push_back(getHit);
+
+    // The same hit keys in batches; ops/sec counts keys and the latencies are per batch
+    BenchResult getMany = makeResult("get-many");
+    {
+        vector<string_view> batchKeys(ops);
+        for (size_t i = 0; i < ops; i++) batchKeys[i] = keys[hitPattern[i]];
+        vector<optional<int>> values(GET_MANY_BATCH);
+        size_t batches = ops / GET_MANY_BATCH;
+        resetProbes(table);
+        measurePhase(batches, [&](size_t i) {
+            span<const string_view> batch(batchKeys.data() + i * GET_MANY_BATCH, GET_MANY_BATCH);
+            sink = sink + table.get_many(batch, span<optional<int>>(values));
+        }, getMany);
+        getMany.opsPerSec *= GET_MANY_BATCH;
+        collectProbes(table, getMany);
+    }
+    results.push_back(getMany);
+
+    BenchResult getMiss = makeResult("get-miss");
+    resetProbes(table);
+    measurePhase(ops, [&](size_t i) { sink = sink + table.get(missKeys[missPattern[i]]).value_or(0); }, getMiss);
+    collectProbes(table, getMiss);
+    results.push_back(getMiss);
+
+    BenchResult containsResult = makeResult("contains");
+    resetProbes(table);
+    measurePhase(ops, [&](size_t i) {
+        const string& key = (i & 1) ? missKeys[missPattern[i]] : keys[hitPattern[i]];
+        sink = sink + table.contains(key);
+    }, containsResult);
+    collectProbes(table, containsResult);
+    results.push_back(containsResult);
+
+    BenchResult bracket = makeResult("operator[]");
+    resetProbes(table);
+    measurePhase(ops, [&](size_t i) { table[keys[hitPattern[i]]]++; }, bracket);
+    collectProbes(table, bracket);
+    results.push_back(bracket);
+
+    BenchResult removeResult = makeResult("remove");
+    resetProbes(table);
+    measurePhase(size, [&](size_t i) { sink = sink + table.remove(keys[i]); }, removeResult);
+    collectProbes(table, removeResult);
+    results.push_back(removeResult);
+
+    // Whole key set in one insert_bulk() call: a single timed operation, so no latency percentiles
+    BenchResult bulkResult = makeResult("insert-bulk");
+    {
+        vector<pair<string, int>> batch;
+        batch.reserve(size);
+        for (size_t i = 0; i < size; i++) batch.emplace_back(keys[i], static_cast<int>(i));
+        Table bulkTable;
+        if (config.maxLoad > 0) bulkTable.max_load_factor(config.maxLoad);
+        resetProbes(bulkTable);
+        auto start = Clock::now();
+        bulkTable.insert_bulk(std::move(batch));
+        bulkResult.opsPerSec = size / max(nanosBetween(start, Clock::now()), 1.0) * 1e9;
+        collectProbes(bulkTable, bulkResult);
+    }
+    results.push_back(bulkResult);
+
+    for (BenchResult& result : results) {
+        if (result.table == tableName && result.workload == workload && result.size == size) {
+            result.bytesPerEntry = bytesPerEntry;
+        }
+    }
+}
+
+// TABLE CONFIGURATIONS - each one can be selected by name with --tables
+
+using WorkloadRunner = void (*)(const string&, const string&, size_t, const BenchConfig&, vector<BenchResult>&);
+
+struct TableConfig {
+    string name;
+    WorkloadRunner run;
+};
+
+static const vector<TableConfig> TABLE_CONFIGS = {
+    {"HashTable", runWorkload<HashTable>},
+    {"Polynomial", runWorkload<BasicHashTable<string, int, PolynomialHash>>},
+    {"Stripe", runWorkload<BasicHashTable<string, int, StripeHash>>},
+    {"Group", runWorkload<GroupHashTable<>>},
+    {"Linear", runWorkload<ProbingHashTable<LinearProbing>>},
+    {"Triangular", runWorkload<ProbingHashTable<TriangularProbing>>},
+    {"RobinHood", runWorkload<RobinHoodHashTable<>>},
+    {"Cuckoo", runWorkload<CuckooHashTable<>>},
+    {"HugePage", runWorkload<HugePageHashTable<>>},
+    {"Incremental", runWorkload<HashTable, true>},
+};
+
+// HASH FUNCTION THROUGHPUT
+
+template<typename Hash>
+static void benchHash(const string& name, const vector<string>& keys) {
+    Hash hash;
+    size_t bytes = 0;
+    volatile size_t sink = 0;  // Keeps the hashing from being optimized away
+    auto start = Clock::now();
+    for (int round = 0; round < 8; round++) {
+        for (const string& key : keys) {
+            sink = sink + hash(key);
+            bytes += key.size();
+        }
+    }
+    double elapsed = nanosBetween(start, Clock::now());
+    cout << left << setw(14) << name << right << setw(8) << keys.front().size() << fixed << setprecision(2)
+         << setw(12) << bytes / max(elapsed, 1.0) << setw(12) << elapsed / (8.0 * keys.size()) << endl;
+}
+
+// Raw hashing speed of every policy, one row per policy and key length
+static void benchHashes(const vector<size_t>& lengths) {
+    cout << "\n" << left << setw(14) << "hash" << right << setw(8) << "length" << setw(12) << "GB/s"
+         << setw(12) << "ns/key" << endl;
+    mt19937_64 rng(7);
+    for (size_t length : lengths) {
+        size_t count = max<size_t>(64, (1 << 24) / max<size_t>(length, 1));
+        vector<string> keys(count, string(length, ' '));
+        for (string& key : keys) {
+            for (char& c : key) c = static_cast<char>(rng());
+        }
+        benchHash<PolynomialHash>("Polynomial", keys);
+        benchHash<WyHash>("WyHash", keys);
+        benchHash<StripeHash>("StripeHash", keys);
+    }
+}
+
+// MULTI-THREADED THROUGHPUT
+
+// HashTable shared the simple way: every operation holds one mutex
+struct MutexTable {
+    HashTable table;
+    mutex lock;
+
+    optional<int> get(string_view key) {
+        lock_guard<mutex> guard(lock);
+        return table.get(key);
+    }
+    void insert_or_assign(const string& key, int value) {
+        lock_guard<mutex> guard(lock);
+        if (int* stored = table.find(key)) *stored = value;
+        else table.insert(key, value);
+    }
+    void increment(const string& key) {
+        lock_guard<mutex> guard(lock);
+        table[key]++;
+    }
+};
+
+/*
+Run `threads` threads of `ops` operations each against one shared table holding `keys`;
+readPercent of the operations are get(), the rest insert_or_assign() of an existing key
+@return: total operations per second
+ */
+template<typename Table, typename Key>
+static double runThreads(Table& table, const vector<Key>& keys, size_t threads, size_t ops, unsigned readPercent) {
+    atomic<bool> start{false};
+    atomic<long long> sink{0};
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            mt19937_64 rng(t + 1);
+            long long local = 0;
+            while (!start.load(memory_order_acquire)) this_thread::yield();
+            for (size_t i = 0; i < ops; i++) {
+                const Key& key = keys[rng() % keys.size()];
+                if (rng() % 100 < readPercent) local += table.get(key).value_or(0);
+                else table.insert_or_assign(key, static_cast<int>(i));
+            }
+            sink += local;
+        });
+    }
+    auto begin = Clock::now();
+    start.store(true, memory_order_release);
+    for (thread& worker : workers) worker.join();
+    return static_cast<double>(threads * ops) / max(nanosBetween(begin, Clock::now()), 1.0) * 1e9;
+}
+
+/*
+Run `threads` threads of `ops` counter increments each, increment(key) on random keys of the set
+@return: total increments per second
+ */
+template<typename Increment>
+static double runCounters(Increment increment, const vector<string>& keys, size_t threads, size_t ops) {
+    atomic<bool> start{false};
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            mt19937_64 rng(t + 1);
+            while (!start.load(memory_order_acquire)) this_thread::yield();
+            for (size_t i = 0; i < ops; i++) increment(keys[rng() % keys.size()]);
+        });
+    }
+    auto begin = Clock::now();
+    start.store(true, memory_order_release);
+    for (thread& worker : workers) worker.join();
+    return static_cast<double>(threads * ops) / max(nanosBetween(begin, Clock::now()), 1.0) * 1e9;
+}
+
+// One row of the multi-threaded table; scaling is relative to the single-thread rate of the series
+static void printThreadRow(const char* name, const string& mix, size_t threads, double opsPerSec, double single) {
+    cout << left << setw(12) << name << setw(13) << mix << right << setw(8) << threads << fixed
+         << setprecision(0) << setw(14) << opsPerSec << setprecision(2) << setw(9)
+         << opsPerSec / single << "x" << endl;
+}
+
+// Mutex vs ConcurrentHashTable for every requested thread count and both mixes, then the counters
+// mix (adding ShardedHashTable) and locked vs lock-free reads
+static void benchThreads(const BenchConfig& config) {
+    vector<string> keys = makeKeys("uniform", config.maxSize, false);
+    cout << "\n" << left << setw(12) << "table" << setw(13) << "mix" << right << setw(8) << "threads"
+         << setw(14) << "ops/sec" << setw(10) << "scaling" << endl;
+
+    for (unsigned readPercent : {90u, 50u}) {
+        string mix = readPercent == 90 ? "read-heavy" : "write-heavy";
+        for (const char* name : {"Mutex", "Concurrent"}) {
+            double single = 0;
+            for (size_t threads : config.threads) {
+                double opsPerSec;
+                if (string(name) == "Mutex") {
+                    MutexTable table;
+                    for (size_t i = 0; i < keys.size(); i++) table.table.insert(keys[i], static_cast<int>(i));
+                    opsPerSec = runThreads(table, keys, threads, config.lookupOps, readPercent);
+                } else {
+                    ConcurrentHashTable<> table;
+                    for (size_t i = 0; i < keys.size(); i++) table.insert(keys[i], static_cast<int>(i));
+                    opsPerSec = runThreads(table, keys, threads, config.lookupOps, readPercent);
+                }
+                if (single == 0) single = opsPerSec / static_cast<double>(threads);
+                printThreadRow(name, mix, threads, opsPerSec, single);
+            }
+        }
+    }
+
+    auto count = [](int& value) { value++; };
+    for (const char* name : {"Mutex", "Concurrent", "Sharded"}) {
+        double single = 0;
+        for (size_t threads : config.threads) {
+            double opsPerSec;
+            if (string(name) == "Mutex") {
+                MutexTable table;
+                opsPerSec = runCounters([&](const string& key) { table.increment(key); }, keys, threads, config.lookupOps);
+            } else if (string(name) == "Concurrent") {
+                ConcurrentHashTable<> table;
+                opsPerSec = runCounters([&](const string& key) {
+                    if (!table.update(key, count)) {
+                        table.insert(key, 0);
+                        table.update(key, count);
+                    }
+                }, keys, threads, config.lookupOps);
+            } else {
+                ShardedHashTable<> table;
+                opsPerSec = runCounters([&](const string& key) { table.upsert(key, count); }, keys, threads, config.lookupOps);
+            }
+            if (single == 0) single = opsPerSec / static_cast<double>(threads);
+            printThreadRow(name, "counters", threads, opsPerSec, single);
+        }
+    }
+
+    using U64Hash = DefaultHash<uint64_t>;
+    using U64Alloc = allocator<pair<const uint64_t, int>>;
+    vector<uint64_t> ids(keys.size());
+    mt19937_64 rng(7);
+    for (uint64_t& id : ids) id = rng();
+    for (const char* name : {"Locked", "LockFree"}) {
+        double single = 0;
+        for (size_t threads : config.threads) {
+            double opsPerSec;
+            if (string(name) == "Locked") {
+                ConcurrentHashTable<uint64_t, int, U64Hash, equal_to<>, U64Alloc, false> table;
+                for (size_t i = 0; i < ids.size(); i++) table.insert(ids[i], static_cast<int>(i));
+                opsPerSec = runThreads(table, ids, threads, config.lookupOps, 99);
+            } else {
+                ConcurrentHashTable<uint64_t, int, U64Hash, equal_to<>, U64Alloc, true> table;
+                for (size_t i = 0; i < ids.size(); i++) table.insert(ids[i], static_cast<int>(i));
+                opsPerSec = runThreads(table, ids, threads, config.lookupOps, 99);
+            }
+            if (single == 0) single = opsPerSec / static_cast<double>(threads);
+            printThreadRow(name, "config-cache", threads, opsPerSec, single);
+        }
+    }
+}
+
+// One doubling rehash of a table holding max(--max-size, PARALLEL_REHASH_MIN) keys, per worker count
+static void benchRehash(const BenchConfig& config) {
+    vector<string> keys = makeKeys("uniform", max(config.maxSize, HashTable::PARALLEL_REHASH_MIN), false);
+    cout << "\n" << left << setw(12) << "rehash" << right << setw(11) << "entries" << setw(8) << "threads"
+         << setw(12) << "pause ms" << setw(10) << "speedup" << endl;
+
+    double single = 0;
+    for (size_t threads : config.threads) {
+        HashTable table;
+        table.reserve(keys.size());  // Filled without any resize, so only the timed one below runs
+        for (size_t i = 0; i < keys.size(); i++) table.insert(keys[i], static_cast<int>(i));
+        table.setRehashThreads(threads);
+
+        auto begin = Clock::now();
+        table.reserve(table.capacity());  // capacityFor(capacity) is twice the capacity
+        double millis = nanosBetween(begin, Clock::now()) / 1e6;
+        if (single == 0) single = millis * static_cast<double>(threads);
+        cout << left << setw(12) << "HashTable" << right << setw(11) << keys.size() << setw(8) << threads
+             << fixed << setprecision(1) << setw(12) << millis << setprecision(2) << setw(9)
+             << single / millis << "x" << endl;
+    }
+}
+
+// REPORTING AND BASELINES
+
+static const char* CSV_HEADER =
+    "table,workload,size,op,ops_per_sec,p50_ns,p99_ns,p999_ns,bytes_per_entry,avg_probes,max_probes";
+
+static void printResult(const BenchResult& r) {
+    cout << left << setw(12) << r.table << setw(13) << r.workload << right << setw(11) << r.size << "  "
+         << left << setw(11) << r.op << right << fixed << setprecision(0)
+         << setw(14) << r.opsPerSec << setw(9) << r.p50 << setw(9) << r.p99 << setw(10) << r.p999
+         << setprecision(1) << setw(10) << r.bytesPerEntry << setprecision(2) << setw(10) << r.avgProbes
+         << setw(10) << r.maxProbes << endl;
+}
+
+static void printHeader() {
+    cout << left << setw(12) << "table" << setw(13) << "workload" << right << setw(11) << "size" << "  "
+         << left << setw(11) << "op" << right << setw(14) << "ops/sec" << setw(9) << "p50 ns"
+         << setw(9) << "p99 ns" << setw(10) << "p999 ns" << setw(10) << "B/entry"
+         << setw(10) << "avg probe" << setw(10) << "max probe" << endl;
+}
+
+static bool saveBaseline(const string& path, const vector<BenchResult>& results) {
+    ofstream out(path);
+    if (!out) return false;
+    out << CSV_HEADER << "\n";
+    for (const BenchResult& r : results) {
+        out << r.table << "," << r.workload << "," << r.size << "," << r.op << "," << r.opsPerSec << ","
+            << r.p50 << "," << r.p99 << "," << r.p999 << "," << r.bytesPerEntry << ","
+            << r.avgProbes << "," << r.maxProbes << "\n";
+    }
+    return true;
+}
+
+using BaselineKey = tuple<string, string, size_t, string>;
+
+static map<BaselineKey, BenchResult> loadBaseline(const string& path) {
+    map<BaselineKey, BenchResult> baseline;
+    ifstream in(path);
+    string line;
+    getline(in, line);  // Skip header
+    while (getline(in, line)) {
+        stringstream row(line);
+        BenchResult r;
+        string field;
+        getline(row, r.table, ',');
+        getline(row, r.workload, ',');
+        getline(row, field, ','); r.size = stoull(field);
+        getline(row, r.op, ',');
+        getline(row, field, ','); r.opsPerSec = stod(field);
+        getline(row, field, ','); r.p50 = stod(field);
+        getline(row, field, ','); r.p99 = stod(field);
+        getline(row, field, ','); r.p999 = stod(field);
+        getline(row, field, ','); r.bytesPerEntry = stod(field);
+        getline(row, field, ','); r.avgProbes = stod(field);
+        getline(row, field, ','); r.maxProbes = stoull(field);
+        baseline[{r.table, r.workload, r.size, r.op}] = r;
+    }
+    return baseline;
+}
+
+/*
+Compare this run against a saved baseline
+@return: number of regressions (throughput drop or p99 rise beyond the tolerance)
+ */
+static size_t compareBaseline(const string& path, const vector<BenchResult>& results, double tolerance) {
+    map<BaselineKey, BenchResult> baseline = loadBaseline(path);
+    size_t regressions = 0;
+    double allowed = tolerance / 100.0;
+    cout << "\nComparing against baseline " << path << " (tolerance " << defaultfloat << tolerance << "%)" << endl;
+    for (const BenchResult& r : results) {
+        auto found = baseline.find({r.table, r.workload, r.size, r.op});
+        if (found == baseline.end()) continue;
+        const BenchResult& base = found->second;
+        bool slower = r.opsPerSec < base.opsPerSec * (1.0 - allowed);
+        bool tail = base.p99 > 0 && r.p99 > base.p99 * (1.0 + allowed);
+        if (slower || tail) {
+            regressions++;
+            cout << "REGRESSION: " << r.table << " " << r.workload << " " << r.size << " " << r.op
+                 << fixed << setprecision(0) << "  ops/sec " << base.opsPerSec << " -> " << r.opsPerSec
+                 << "  p99 " << base.p99 << " -> " << r.p99 << " ns" << endl;
+        }
+    }
+    if (regressions == 0) cout << "No regressions" << endl;
+    return regressions;
+}
+
+// COMMAND LINE
+
+static vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream in(list);
+    string item;
+    while (getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static vector<string> expandTables(const string& list) {
+    if (list != "all") return splitList(list);
+    vector<string> names;
+    for (const TableConfig& table : TABLE_CONFIGS) names.push_back(table.name);
+    return names;
+}
+
+static bool parseArgs(int argc, char* argv[], BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--min-size") config.minSize = stoull(value);
+        else if (arg == "--max-size") config.maxSize = stoull(value);
+        else if (arg == "--ops") config.lookupOps = stoull(value);
+        else if (arg == "--adversarial-max") config.adversarialMax = stoull(value);
+        else if (arg == "--workloads") config.workloads = splitList(value);
+        else if (arg == "--tables") config.tables = expandTables(value);
+        else if (arg == "--hash-lengths") {
+            for (const string& length : splitList(value)) config.hashLengths.push_back(stoull(length));
+        }
+        else if (arg == "--save") config.saveFile = value;
+        else if (arg == "--compare") config.compareFile = value;
+        else if (arg == "--tolerance") config.tolerance = stod(value);
+        else if (arg == "--max-load") config.maxLoad = stod(value);
+        else if (arg == "--threads") {
+            for (const string& count : splitList(value)) config.threads.push_back(stoull(count));
+        }
+        else {
+            cerr << "Unknown option " << arg << endl;
+            return false;
+        }
+    }
+    return config.minSize > 0 && config.minSize <= config.maxSize;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        cerr << "usage: HashTableBench [--min-size N] [--max-size N] [--ops N] [--workloads a,b,...]"
+                " [--tables a,b,...|all] [--hash-lengths n,m,...]"
+                " [--adversarial-max N] [--max-load X] [--threads n,m,...]"
+                " [--save FILE] [--compare FILE] [--tolerance PCT]" << endl;
+        return 2;
+    }
+
+    cout << "+======================+" << endl;
+    cout << "| HASH TABLE BENCHMARK |" << endl;
+    cout << "+======================+" << endl << endl;
+    printHeader();
+
+    vector<BenchResult> results;
+    for (const string& tableName : config.tables) {
+        auto table = find_if(TABLE_CONFIGS.begin(), TABLE_CONFIGS.end(),
+                             [&](const TableConfig& t) { return t.name == tableName; });
+        if (table == TABLE_CONFIGS.end()) {
+            cerr << "Unknown table configuration " << tableName << endl;
+            return 2;
+        }
+        for (const string& workload : config.workloads) {
+            for (size_t size = config.minSize; size <= config.maxSize; size *= 10) {
+                size_t effective = workload == "adversarial" ? min(size, config.adversarialMax) : size;
+
+                size_t first = results.size();
+                table->run(table->name, workload, effective, config, results);
+                for (size_t i = first; i < results.size(); i++) printResult(results[i]);
+
+                if (effective < size) break;  // Capped workload: larger sizes would repeat it
+            }
+        }
+    }
+
+    if (!config.hashLengths.empty()) {
+        benchHashes(config.hashLengths);
+    }
+
+    if (!config.threads.empty()) {
+        benchThreads(config);
+        benchRehash(config);
+    }
+
+    if (!config.saveFile.empty()) {
+        if (saveBaseline(config.saveFile, results))
+            cout << "\nBaseline saved to " << config.saveFile << endl;
+        else
+            cerr << "Unable to write baseline " << config.saveFile << endl;
+    }
+    if (!config.compareFile.empty() && compareBaseline(config.compareFile, results, config.tolerance) > 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -2,10 +2,17 @@
 #ifdef RUN_TESTS
 
 #include "HashTable.h"
+#include "ConcurrentHashTable.h"
+#include "ShardedHashTable.h"
+#include "CuckooHashTable.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <optional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <atomic>
 
 using namespace std;
 
@@ -29,10 +36,27 @@ using namespace std;
 #define HT_GET_AFTER_REMOVE    // Test get after removal
 #define HT_BRACKET_OP_GET      // Test operator[] for reading
 #define HT_BRACKET_OP_SET      // Test operator[] for assignment
+#define HT_TRY_EMPLACE         // Test operator[] counters, try_emplace() and insert_or_assign()
 #define HT_KEYS                // Test retrieving all keys
 #define HT_ALPHA               // Test load factor calculation
 #define HT_CAPACITY            // Test table capacity reporting
 #define HT_SIZE                // Test size reporting
+#define HT_STRING_VIEW         // Test string_view lookups, emplace() and find()
+#define HT_INLINE_KEYS         // Test short keys kept in the bucket and long keys in the key arena
+#define HT_GENERIC             // Test BasicHashTable with non-string keys and other value types
+#define HT_PROBE_POLICIES      // Test the linear, triangular, SIMD group and Robin Hood probe policies
+#define HT_ROBIN_HOOD          // Test Robin Hood probing at high load: backward-shift removal leaves no tombstones
+#define HT_CUCKOO              // Test CuckooHashTable at load 0.95, its stash and a hash that defeats both buckets
+#define HT_INCREMENTAL_RESIZE  // Test incremental resizing and its progress report
+#define HT_TOMBSTONES          // Test tombstone counting, automatic cleanup and compact()
+#define HT_LOAD_FACTOR         // Test max_load_factor(), reserve(), shrink_to_fit() and auto-shrink
+#define HT_PARALLEL_REHASH     // Test rehashing a table of over 1M entries on worker threads
+#define HT_HUGE_PAGES          // Test HugePageAllocator: mapped large arrays, aligned small ones
+#define HT_BULK                // Test insert_bulk() and from_range() with each duplicate policy
+#define HT_BATCH_LOOKUP        // Test get_many() and contains_many()
+#define HT_CONCURRENT          // Test ConcurrentHashTable from several threads at once
+#define HT_LOCK_FREE_READS     // Test lock-free get()/contains() while a writer inserts and resizes
+#define HT_SHARDED             // Test ShardedHashTable counters, aggregate views and parallel merge
 
 int main() {
     const size_t MAXHASH = 8; // matches default constructor size
@@ -207,6 +231,39 @@ int main() {
     }
 #endif
 
+#ifdef HT_TRY_EMPLACE
+    // Count words through operator[] (also across an incremental resize), then the explicit forms
+    cout << "\nTesting operator[] counters, try_emplace() and insert_or_assign()" << endl;
+    try {
+        HashTable counts;
+        counts.setIncrementalResize(true);
+        string text = "the cat and the dog and the bird";
+        for (size_t start = 0; start < text.size();) {
+            size_t end = std::min(text.find(' ', start), text.size());
+            counts[string_view(text).substr(start, end - start)]++;
+            start = end + 1;
+        }
+        for (int i = 0; i < 5000; i++) counts[to_string(i % 2500)] += 2;
+        bool ok = counts.size() == 2505 && counts["the"] == 3 && counts["and"] == 2 && counts["cat"] == 1;
+        ok = ok && counts["0"] == 4 && counts["2499"] == 4 && counts.size() == 2505;
+
+        BasicHashTable<string, vector<int>> lists;
+        vector<int> values = {1, 2, 3};
+        auto [first, inserted] = lists.try_emplace("a", std::move(values));
+        ok = ok && inserted && first->size() == 3;
+        vector<int> other = {4};
+        auto [again, insertedAgain] = lists.try_emplace("a", std::move(other));
+        ok = ok && !insertedAgain && again == first && other.size() == 1;  // Not moved from: "a" was stored
+        ok = ok && lists.try_emplace("b", size_t(2), 7).second && lists.get("b") == vector<int>{7, 7};
+
+        ok = ok && counts.insert_or_assign("the", 10) == false && counts.get("the") == 10;
+        ok = ok && counts.insert_or_assign("fish", 1) == true && counts.get("fish") == 1;
+        cout << (ok ? "CORRECT: single-walk upserts work" : "ERROR: operator[]/try_emplace/insert_or_assign failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
 #ifdef HT_KEYS
     //  Test retrieving all keys from the table
     cout << "\nTesting HashTable::keys()" << endl;
@@ -262,6 +319,480 @@ int main() {
     }
 #endif
 
+#ifdef HT_STRING_VIEW
+    // Lookups through string_view / const char* and insertion that builds the key only when new
+    cout << "\nTesting string_view lookups, emplace() and find()" << endl;
+    try {
+        HashTable ht;
+        const char* buffer = "alpha,beta";
+        string_view alpha(buffer, 5);  // Slice of a larger buffer, not null-terminated
+        ht.emplace(alpha, 1);
+        ht.insert(string("beta"), 2);
+        bool ok = ht.contains("alpha") && ht.get(string_view(buffer + 6, 4)) == 2;
+        ok = ok && !ht.emplace("alpha", 99) && ht.get("alpha") == 1;  // Duplicate rejected
+        if (int* value = ht.find(alpha)) *value = 10;
+        ok = ok && ht.get("alpha") == 10 && ht.find("gamma") == nullptr;
+        ok = ok && ht.remove(alpha) && !ht.contains(alpha);
+        cout << (ok ? "CORRECT: string_view API works" : "ERROR: string_view API failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_INLINE_KEYS
+    // Keys on both sides of InlineKey::INLINE_CAPACITY, then churn long keys so the arena is compacted
+    cout << "\nTesting inline and arena string keys" << endl;
+    try {
+        HashTable ht;
+        string shortKey(bucket_detail::InlineKey::INLINE_CAPACITY, 's');
+        string longKey(bucket_detail::InlineKey::INLINE_CAPACITY + 1, 'l');
+        bool ok = ht.insert(shortKey, 1) && ht.insert(longKey, 2) && ht.insert("", 3);
+        for (int i = 0; i < 20000; i++) {
+            string key = longKey + to_string(i);
+            ok = ok && ht.insert(key, i);
+            if (i % 4) ok = ok && ht.remove(key);
+        }
+        ok = ok && ht.size() == 5003 && ht.get(shortKey) == 1 && ht.get(longKey) == 2 && ht.get("") == 3;
+        for (int i = 0; i < 20000; i += 4) ok = ok && ht.get(longKey + to_string(i)) == i;
+        ok = ok && !ht.contains(longKey + "1") && sizeof(HashTable::Bucket) == 40;
+        cout << (ok ? "CORRECT: inline and arena keys round-trip" : "ERROR: inline or arena key lost") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_GENERIC
+    // The same table over integer keys (compact 16-byte buckets) and over string keys with 64-bit values
+    cout << "\nTesting BasicHashTable with other key and value types" << endl;
+    try {
+        BasicHashTable<uint64_t, int> ids;
+        for (uint64_t i = 0; i < 1000; i++) ids.insert(i * 4096, static_cast<int>(i));
+        bool ok = ids.size() == 1000 && ids.get(4096 * 999) == 999 && !ids.contains(1);
+        ok = ok && ids.remove(0) && !ids.contains(0) && ids.size() == 999;
+        ok = ok && sizeof(BasicHashTableBucket<uint64_t, int>) == 16 && !BasicHashTableBucket<uint64_t, int>::CACHES_HASH;
+
+        BasicHashTable<string, int64_t> totals;
+        totals["bytes"] += int64_t(1) << 40;
+        totals["bytes"] += 1;
+        ok = ok && totals.get("bytes") == (int64_t(1) << 40) + 1;
+        cout << (ok ? "CORRECT: generic key and value types work" : "ERROR: generic table failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_PROBE_POLICIES
+    // Every probe policy must behave exactly like the default, including in tables smaller than one group
+    cout << "\nTesting probe policies (linear, triangular, group, Robin Hood)" << endl;
+    try {
+        auto check = [](auto ht) {
+            bool ok = ht.capacity() == HashTable::DEFAULT_INITIAL_CAPACITY;
+            for (int i = 0; i < 1000; i++) ok = ok && ht.insert(to_string(i), i);
+            for (int i = 0; i < 1000; i += 2) ok = ok && ht.remove(to_string(i));
+            for (int i = 0; i < 1000; i++) ok = ok && ht.contains(to_string(i)) == (i % 2 == 1);
+            return ok && !ht.insert("7", 0) && ht.insert("8", 8) && ht.get("8") == 8 && ht.size() == 501;
+        };
+        bool ok = check(ProbingHashTable<LinearProbing>()) && check(ProbingHashTable<TriangularProbing>()) &&
+                  check(GroupHashTable<>()) && check(RobinHoodHashTable<>());
+        cout << (ok ? "CORRECT: probe policies work" : "ERROR: probe policy failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_ROBIN_HOOD
+    // Fill to 0.9, remove every third key and refill: removals shift entries back instead of leaving EAR
+    cout << "\nTesting Robin Hood probing at load 0.9" << endl;
+    try {
+        RobinHoodHashTable<uint64_t, int> ht;
+        ht.max_load_factor(0.9);
+        bool ok = true;
+        for (uint64_t i = 0; i < 100000; i++) ok = ok && ht.insert(i * 31, static_cast<int>(i));
+        for (uint64_t i = 0; i < 100000; i += 3) ok = ok && ht.remove(i * 31);
+        ok = ok && ht.tombstoneCount() == 0 && ht.size() == 66666;
+        for (uint64_t i = 0; i < 100000; i++) ok = ok && ht.contains(i * 31) == (i % 3 != 0);
+        for (uint64_t i = 0; i < 100000; i += 3) ok = ok && ht.insert(i * 31, -1);
+        ok = ok && ht.size() == 100000 && ht.get(0) == -1 && ht.get(31) == 1 && ht.alpha() > 0.3;
+        ht[7]++;
+        ok = ok && ht.get(7) == 1 && ht.tombstoneCount() == 0;
+        cout << (ok ? "CORRECT: Robin Hood probing works" : "ERROR: Robin Hood probing failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_CUCKOO
+    // Fill to 0.95, remove every third key and refill; then keys that all share two buckets, which only the stash can hold
+    cout << "\nTesting CuckooHashTable at load 0.95" << endl;
+    try {
+        CuckooHashTable<uint64_t, int> ht;
+        ht.max_load_factor(0.95);
+        bool ok = true;
+        for (uint64_t i = 0; i < 100000; i++) ok = ok && ht.insert(i * 31, static_cast<int>(i));
+        for (uint64_t i = 0; i < 100000; i += 3) ok = ok && ht.remove(i * 31);
+        ok = ok && ht.size() == 66666;
+        for (uint64_t i = 0; i < 100000; i++) ok = ok && ht.contains(i * 31) == (i % 3 != 0);
+        for (uint64_t i = 0; i < 100000; i += 3) ok = ok && ht.insert(i * 31, -1);
+        ht[7]++;
+        ok = ok && ht.size() == 100001 && ht.get(0) == -1 && ht.get(31) == 1 && ht.get(7) == 1;
+        ok = ok && ht.stashSize() <= decltype(ht)::STASH_CAPACITY && ht.keys().size() == 100001;
+
+        struct SameBuckets { size_t operator()(uint64_t) const { return 42; } };
+        CuckooHashTable<uint64_t, int, SameBuckets> colliding;
+        for (uint64_t i = 0; i < 100; i++) ok = ok && colliding.insert(i, static_cast<int>(i));
+        for (uint64_t i = 0; i < 100; i++) ok = ok && colliding.get(i) == static_cast<int>(i);
+        ok = ok && colliding.stashSize() == 100 - 2 * decltype(colliding)::SLOTS_PER_BUCKET && colliding.capacity() <= 1024;
+
+        CuckooHashTable<> words;
+        words.insert("apple", 1);
+        words.emplace(string_view("pear"), 2);
+        vector<string_view> batch = {"apple", "plum", "pear"};
+        vector<optional<int>> values(batch.size());
+        ok = ok && words.get_many(span<const string_view>(batch), span<optional<int>>(values)) == 2;
+        ok = ok && values[0] == 1 && !values[1] && values[2] == 2;
+        cout << (ok ? "CORRECT: cuckoo table works" : "ERROR: cuckoo table failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_INCREMENTAL_RESIZE
+    // Entries stay reachable while they are spread over the old and new arrays
+    cout << "\nTesting incremental resizing" << endl;
+    try {
+        HashTable ht;
+        ht.setIncrementalResize(true);
+        bool ok = true, sawMigration = false;
+        for (int i = 0; i < 5000; i++) {
+            ok = ok && ht.insert(to_string(i), i);
+            if (ht.isMigrating()) {
+                sawMigration = true;
+                ok = ok && ht.migrationProgress() < 1.0 && ht.get("0") == 0 && ht.contains(to_string(i));
+            }
+        }
+        ok = ok && sawMigration && !ht.insert("42", 0) && ht.remove("42") && ht.size() == 4999;
+        ht.finishMigration();
+        ok = ok && !ht.isMigrating() && ht.migrationProgress() == 1.0 && ht.keys().size() == 4999;
+        cout << (ok ? "CORRECT: incremental resizing works" : "ERROR: incremental resizing failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+
+    // Below a 1/16 load factor each step moves more buckets, so a migration still ends before the next resize
+    try {
+        HashTable ht;
+        ht.max_load_factor(0.02);
+        ht.setIncrementalResize(true);
+        bool ok = true;
+        size_t resizes = 0;
+        for (int i = 0; i < 20000; i++) {
+            size_t capacity = ht.capacity();
+            bool migrating = ht.isMigrating();
+            ht.insert(to_string(i), i);
+            if (ht.capacity() != capacity) {
+                resizes++;
+                ok = ok && !migrating;
+            }
+        }
+        for (int i = 0; i < 20000; i++) ok = ok && ht.get(to_string(i)) == i;
+        ok = ok && resizes >= 5;
+        cout << (ok ? "CORRECT: migration keeps up with a low load factor" : "ERROR: migration fell behind a low load factor") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_TOMBSTONES
+    // Insert/remove churn must not leave the table full of EAR buckets
+    cout << "\nTesting tombstone cleanup and compact()" << endl;
+    try {
+        HashTable ht;
+        for (int i = 0; i < 100; i++) ht.insert(to_string(i), i);
+        size_t capacity = ht.capacity();
+        for (int i = 0; i < 100000; i++) {
+            ht.insert("session" + to_string(i), i);
+            ht.remove("session" + to_string(i));
+        }
+        bool ok = ht.size() == 100 && ht.capacity() <= 2 * capacity && ht.tombstoneCount() < ht.capacity() / 2;
+        ht.compact();
+        ok = ok && ht.tombstoneCount() == 0 && ht.size() == 100;
+        for (int i = 0; i < 100; i++) ok = ok && ht.get(to_string(i)) == i;
+        cout << (ok ? "CORRECT: tombstones are cleaned up" : "ERROR: tombstone cleanup failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_LOAD_FACTOR
+    // Sizing controls: a reserved table never resizes, and emptied tables give memory back
+    cout << "\nTesting max_load_factor(), reserve() and shrink_to_fit()" << endl;
+    try {
+        HashTable ht;
+        ht.max_load_factor(0.875);
+        ht.reserve(1000);
+        size_t reserved = ht.capacity();
+        for (int i = 0; i < 1000; i++) ht.insert(to_string(i), i);
+        bool ok = ht.capacity() == reserved && reserved == 2048 && ht.alpha() > 0.45;
+
+        for (int i = 0; i < 990; i++) ht.remove(to_string(i));
+        ok = ok && ht.capacity() == reserved;  // Auto-shrink stops at the reserved capacity
+        ht.shrink_to_fit();
+        ok = ok && ht.capacity() == 16 && ht.size() == 10 && ht.get("995") == 995;
+
+        for (int i = 0; i < 5000; i++) ht.insert("k" + to_string(i), i);
+        for (int i = 0; i < 5000; i++) ht.remove("k" + to_string(i));
+        ok = ok && ht.capacity() < 256 && ht.size() == 10;  // Auto-shrink after mass removal
+
+        bool threw = false;
+        try { ht.max_load_factor(1.0); } catch (const invalid_argument&) { threw = true; }
+        ok = ok && threw && ht.max_load_factor() == 0.875;
+
+        // Lowering the load factor on a full table grows it, but must not pin that size as a floor
+        HashTable sparse;
+        for (int i = 0; i < 10000; i++) sparse.insert(to_string(i), i);
+        sparse.max_load_factor(0.25);
+        size_t grown = sparse.capacity();
+        for (int i = 0; i < 9990; i++) sparse.remove(to_string(i));
+        ok = ok && grown >= 40000 && sparse.capacity() <= 256 && sparse.get("9995") == 9995;
+        cout << (ok ? "CORRECT: sizing controls work" : "ERROR: sizing controls failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_PARALLEL_REHASH
+    // Grow past PARALLEL_REHASH_MIN entries so the doubling runs on 4 workers, then check every entry
+    cout << "\nTesting parallel rehash with 4 workers" << endl;
+    try {
+        BasicHashTable<uint64_t, int> ht;
+        ht.setRehashThreads(4);
+        const size_t count = ht.PARALLEL_REHASH_MIN + 1000;
+        for (size_t i = 0; i < count; i++) ht.insert(i * 7919, static_cast<int>(i));
+
+        bool ok = ht.rehashThreadCount() == 4 && ht.size() == count && ht.capacity() == (size_t(1) << 22);
+        for (size_t i = 0; i < count && ok; i++) ok = ht.get(i * 7919) == static_cast<int>(i);
+        ok = ok && !ht.contains(7918);
+        ht.setRehashThreads(0);
+        ok = ok && ht.rehashThreadCount() >= 1;
+        cout << (ok ? "CORRECT: parallel rehash works" : "ERROR: parallel rehash failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_HUGE_PAGES
+    // A table large enough for mapped arrays; everything mapped must be unmapped with the table
+    cout << "\nTesting HugePageHashTable" << endl;
+    try {
+        bool ok = true;
+        {
+            HugePageHashTable<uint64_t, int> ht;
+            for (uint64_t i = 0; i < 1000000; i++) ht.insert(i * 31, static_cast<int>(i));
+            for (uint64_t i = 0; i < 1000000; i += 7) ok = ok && ht.get(i * 31) == static_cast<int>(i);
+            ok = ok && ht.remove(31) && !ht.contains(31) && ht.size() == 999999;
+#ifdef HASHTABLE_HAS_MMAP
+            ok = ok && hugepage_detail::mappedBytes % hugepage_detail::HUGE_PAGE == 0 && hugepage_detail::mappedBytes > 0;
+#endif
+        }
+        ok = ok && hugepage_detail::mappedBytes == 0;
+
+        HugePageAllocator<char> small;
+        char* block = small.allocate(100);
+        ok = ok && reinterpret_cast<uintptr_t>(block) % hugepage_detail::CACHE_LINE == 0;
+        small.deallocate(block, 100);
+        cout << (ok ? "CORRECT: huge page table works" : "ERROR: huge page table failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_BULK
+    // Bulk building: one sizing step, duplicates resolved by the chosen policy
+    cout << "\nTesting insert_bulk() and from_range()" << endl;
+    try {
+        vector<pair<string, int>> batch;
+        for (int i = 0; i < 1000; i++) batch.emplace_back("key" + to_string(i % 800), i);
+
+        HashTable first = HashTable::from_range(batch);  // Copies: batch is reused below
+        bool ok = first.size() == 800 && first.get("key5") == 5 && first.capacity() == 2048;
+
+        HashTable last;
+        size_t added = last.insert_bulk(batch, DuplicatePolicy::LAST_WINS);
+        ok = ok && added == 800 && last.get("key5") == 805 && last.get("key799") == 799;
+
+        HashTable strict;
+        strict.insert("kept", 1);
+        bool threw = false;
+        try { strict.insert_bulk(batch, DuplicatePolicy::THROW); } catch (const invalid_argument&) { threw = true; }
+        ok = ok && threw && strict.size() == 1 && !strict.contains("key0") && strict.get("kept") == 1;
+
+        HashTable moved = HashTable::from_range(std::move(batch));
+        ok = ok && moved.size() == 800 && moved.get("key799") == 799;
+        cout << (ok ? "CORRECT: bulk building works" : "ERROR: bulk building failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_BATCH_LOOKUP
+    // Batched lookups: results line up with the keys, including during an incremental resize
+    cout << "\nTesting get_many() and contains_many()" << endl;
+    try {
+        HashTable ht;
+        ht.setIncrementalResize(true);
+        vector<string> stored;
+        for (int i = 0; i < 100; i++) {
+            stored.push_back("key" + to_string(i));
+            ht.insert(stored.back(), i);
+        }
+        vector<string_view> query;
+        for (int i = 0; i < 150; i++) query.push_back(i % 3 == 2 ? "absent" : string_view(stored[i % 100]));
+
+        vector<optional<int>> values(query.size());
+        size_t hits = ht.get_many(span<const string_view>(query), span<optional<int>>(values));
+        bool ok = hits == 100 && values[0] == 0 && values[1] == 1 && !values[2] && values[148] == 48;
+
+        unique_ptr<bool[]> present(new bool[query.size()]);
+        ok = ok && ht.contains_many(span<const string_view>(query), span<bool>(present.get(), query.size())) == 100;
+        ok = ok && present[0] && present[1] && !present[2] && present[148];
+
+        bool threw = false;
+        try { ht.get_many(span<const string_view>(query), span<optional<int>>(values).first(10)); }
+        catch (const invalid_argument&) { threw = true; }
+        cout << (ok && threw ? "CORRECT: batched lookups work" : "ERROR: batched lookups failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_CONCURRENT
+    // Several threads inserting, updating and removing in one table while it resizes
+    cout << "\nTesting ConcurrentHashTable with 4 threads" << endl;
+    try {
+        ConcurrentHashTable<> ht;
+        ht.insert("hits", 0);
+        vector<thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&ht, t] {
+                for (int i = 0; i < 5000; i++) {
+                    string key = to_string(t) + "-" + to_string(i);
+                    ht.insert(key, i);
+                    if (i % 2 == 0) ht.remove(key);
+                    ht.update(string_view("hits"), [](int& hits) { hits++; });
+                }
+            });
+        }
+        for (thread& worker : workers) worker.join();
+
+        bool ok = ht.size() == 10001 && ht.get("hits") == 20000 && ht.keys().size() == 10001;
+        ok = ok && ht.get("3-4999") == 4999 && !ht.contains("3-4998") && ht.alpha() <= 0.5;
+        ok = ok && !ht.insert_or_assign("3-4999", -1) && ht.get("3-4999") == -1;
+        cout << (ok ? "CORRECT: concurrent table works" : "ERROR: concurrent table failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_LOCK_FREE_READS
+    // Readers never lock: every value they see must be one the writer stored
+    cout << "\nTesting lock-free reads with 3 readers and 1 writer" << endl;
+    try {
+        ConcurrentHashTable<uint64_t, int> ht;
+        atomic<bool> done{false};
+        atomic<int> wrong{0};
+        vector<thread> readers;
+        for (int t = 0; t < 3; t++) {
+            readers.emplace_back([&ht, &done, &wrong, t] {
+                for (uint64_t k = t; !done.load(); k = (k + 7) % 20000) {
+                    optional<int> value = ht.get(k);
+                    if (value && *value != static_cast<int>(k) && *value != -static_cast<int>(k)) wrong++;
+                }
+            });
+        }
+        for (uint64_t k = 0; k < 20000; k++) {
+            ht.insert(k, static_cast<int>(k));
+            if (k % 4 == 0) ht.insert_or_assign(k, -static_cast<int>(k));
+        }
+        done = true;
+        for (thread& reader : readers) reader.join();
+
+        bool ok = ht.LOCK_FREE_READS && !ConcurrentHashTable<>::LOCK_FREE_READS && wrong == 0;
+        ok = ok && ht.size() == 20000 && ht.get(8) == -8 && ht.get(9) == 9 && !ht.contains(20000);
+
+        // Insert/remove churn under readers: tombstone cleanups and resizes must not pile up old tables
+        ConcurrentHashTable<uint64_t, int> churn;
+        done = false;
+        readers.clear();
+        for (int t = 0; t < 2; t++) {
+            readers.emplace_back([&churn, &done] {
+                for (uint64_t k = 0; !done.load(); k++) churn.contains(k % 40000);
+            });
+        }
+        size_t mostRetired = 0;
+        for (uint64_t k = 0; k < 200000; k++) {
+            churn.insert(k, 1);
+            if (k >= 10000) churn.remove(k - 10000);
+            mostRetired = std::max(mostRetired, churn.retiredTables());
+        }
+        done = true;
+        for (thread& reader : readers) reader.join();
+        churn.insert(1, 1);  // A write after the readers left frees whatever is still retired
+        ok = ok && mostRetired <= churn.MAX_RETIRED && churn.retiredTables() == 0 && churn.size() == 10001;
+        cout << (ok ? "CORRECT: lock-free reads work" : "ERROR: lock-free reads failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
+#ifdef HT_SHARDED
+    // Write-heavy counters from 4 threads, then the aggregate views and both merge paths
+    cout << "\nTesting ShardedHashTable with 4 threads" << endl;
+    try {
+        ShardedHashTable<> ht(6);  // Rounded up to 8 shards
+        vector<thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&ht] {
+                for (int i = 0; i < 5000; i++) ht.upsert("word" + to_string(i % 500), [](int& count) { count++; });
+            });
+        }
+        for (thread& worker : workers) worker.join();
+
+        atomic<int> total{0};
+        ht.for_each([&total](const string&, int count) { total += count; });
+        bool ok = ht.shardCount() == 8 && ht.size() == 500 && ht.keys().size() == 500 && total == 20000;
+        ok = ok && ht.get("word7") == 40 && ht.alpha() <= 0.5 && ht.capacity() >= 1000;
+        ok = ok && ht.update(string_view("word7"), [](int& count) { count = 0; }) && ht.get("word7") == 0;
+        ht.upsert(string_view("fresh"), [](int& count) { count += 2; });  // New: stored as a string
+        ht.upsert(string_view("fresh"), [](int& count) { count += 2; });  // Found without building a string
+        ok = ok && ht.get("fresh") == 4 && ht.remove("fresh") && ht.size() == 500;
+
+        ShardedHashTable<> same(8), other(2);
+        same.insert("word8", 1);
+        same.insert("extra", 5);
+        other.insert("word9", 2);
+        ht.merge(same, [](int& mine, int theirs) { mine += theirs; });
+        ht.merge(other, [](int& mine, int theirs) { mine += theirs; });
+        ok = ok && ht.get("word8") == 41 && ht.get("word9") == 42 && ht.get("extra") == 5 && ht.size() == 501;
+
+        // Same shard count but another seed: the keys sit in other shards, so they must be routed
+        DefaultHash<string> seeded;
+        seeded.seed = 42;
+        ShardedHashTable<> reseeded(8, ShardedHashTable<>::Table::DEFAULT_INITIAL_CAPACITY, seeded);
+        for (int i = 0; i < 500; i++) reseeded.insert("word" + to_string(i), 1);
+        reseeded.insert("seeded", 3);
+        ht.merge(reseeded, [](int& mine, int theirs) { mine += theirs; });
+        ok = ok && ht.size() == 502 && ht.keys().size() == 502 && ht.get("seeded") == 3;
+        ok = ok && ht.get("word8") == 42 && ht.get("word9") == 43 && ht.get("word10") == 41;
+
+        bool threw = false;
+        try { ht.merge(ht, [](int&, int) {}); }
+        catch (const invalid_argument&) { threw = true; }
+        cout << (ok && threw ? "CORRECT: sharded table works" : "ERROR: sharded table failed") << endl;
+    } catch (const exception &e) {
+        cout << "Exception: " << e.what() << endl;
+    }
+#endif
+
     cout << "\nProcess finished with exit code 0" << endl;
     return 0;
 }
@@ -0,0 +1,106 @@
+#ifndef HUGEPAGEALLOCATOR_H
+#define HUGEPAGEALLOCATOR_H
+
+#include <algorithm>    // For std::max
+#include <atomic>       // For std::atomic (mapped byte count)
+#include <cstddef>
+#include <cstdint>      // For uintptr_t
+#include <limits>       // For std::numeric_limits
+#include <new>          // For std::bad_alloc / std::align_val_t
+
+// Anonymous mappings are POSIX; elsewhere every block comes from aligned operator new
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define HASHTABLE_HAS_MMAP 1
+#endif
+
+using namespace std;
+
+// HUGE PAGE ALLOCATOR
+/*
+An allocator for the tables' bucket and control arrays (pass it as the Alloc template parameter,
+or use HugePageHashTable<>). A random probe into a multi-GB array misses the TLB on almost every
+lookup with 4 KiB pages; with 2 MiB pages one TLB entry covers 512 times as much of the table.
+- blocks of MAP_THRESHOLD bytes or more are mapped with mmap, aligned to a huge page and marked
+  MADV_HUGEPAGE, so the kernel backs them with transparent huge pages. When THP is disabled
+  (or the platform has no MADV_HUGEPAGE) the same mapping simply keeps 4 KiB pages
+- smaller blocks come from aligned operator new; they fit in the TLB anyway, and rounding them
+  up to whole huge pages would waste most of the memory
+Every block starts on a cache line, so a bucket never straddles two lines more than its size forces.
+The allocator has no state: any two instances are equal, and rebinding keeps the behaviour
+ */
+namespace hugepage_detail {
+inline constexpr size_t CACHE_LINE = 64;
+inline constexpr size_t HUGE_PAGE = size_t(2) << 20;        // 2 MiB, the x86-64 / AArch64 huge page
+inline constexpr size_t MAP_THRESHOLD = 4 * HUGE_PAGE;      // Rounding wastes under a quarter from here on
+inline atomic<size_t> mappedBytes{0};                       // Bytes currently mapped by every HugePageAllocator
+
+inline size_t roundUp(size_t bytes, size_t unit) { return (bytes + unit - 1) / unit * unit; }
+
+#ifdef HASHTABLE_HAS_MMAP
+/*Map `bytes` (a multiple of HUGE_PAGE) starting on a huge page boundary
+mmap only promises 4 KiB alignment, so one extra huge page is mapped and the unaligned ends are
+unmapped again; a huge page can only back a 2 MiB aligned range
+ */
+inline void* mapHuge(size_t bytes) {
+    void* mapping = mmap(nullptr, bytes + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) throw bad_alloc();
+    char* start = static_cast<char*>(mapping);
+    char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(start), HUGE_PAGE));
+    if (aligned > start) munmap(start, aligned - start);
+    if (aligned + bytes < start + bytes + HUGE_PAGE) munmap(aligned + bytes, start + HUGE_PAGE - aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, bytes, MADV_HUGEPAGE);  // Only a hint: fails harmlessly when THP is off
+#endif
+    mappedBytes += bytes;
+    return aligned;
+}
+
+inline void unmapHuge(void* block, size_t bytes) {
+    munmap(block, bytes);
+    mappedBytes -= bytes;
+}
+#endif
+} // namespace hugepage_detail
+
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    // Room for n objects, cache-line aligned (huge-page aligned and mapped from MAP_THRESHOLD bytes on)
+    T* allocate(size_t n) {
+        if (n > numeric_limits<size_t>::max() / sizeof(T)) throw bad_array_new_length();
+        size_t bytes = n * sizeof(T);
+#ifdef HASHTABLE_HAS_MMAP
+        if (bytes >= hugepage_detail::MAP_THRESHOLD) {
+            return static_cast<T*>(hugepage_detail::mapHuge(hugepage_detail::roundUp(bytes, hugepage_detail::HUGE_PAGE)));
+        }
+#endif
+        return static_cast<T*>(::operator new(bytes, ALIGNMENT));
+    }
+
+    // Release a block from allocate(n); the size alone tells which way it was obtained
+    void deallocate(T* block, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+#ifdef HASHTABLE_HAS_MMAP
+        if (bytes >= hugepage_detail::MAP_THRESHOLD) {
+            hugepage_detail::unmapHuge(block, hugepage_detail::roundUp(bytes, hugepage_detail::HUGE_PAGE));
+            return;
+        }
+#endif
+        ::operator delete(block, ALIGNMENT);
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+
+private:
+    static constexpr align_val_t ALIGNMENT{std::max(hugepage_detail::CACHE_LINE, alignof(T))};
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef PROBEPOLICIES_H
+#define PROBEPOLICIES_H
+
+#include <bit>          // For std::countr_zero (walking match masks)
+#include <cstddef>
+#include <cstdint>
+#include <cstring>      // For std::memcpy (scalar group loads)
+
+// SIMD support is chosen at compile time, as in HashFunctions.h: AVX2 when the compiler targets it
+// (e.g. -march=native / HASHTABLE_NATIVE_ARCH), otherwise SSE2 on any x86-64 build
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HASHTABLE_PROBE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASHTABLE_PROBE_SSE2 1
+#endif
+
+using namespace std;
+
+// PROBE POLICIES
+/*
+A probe policy decides which buckets a lookup visits after the home bucket.
+BasicHashTable takes it as its last template parameter. None of them needs a side table:
+RandomProbing     - the default: pseudo-random order inside a 64-bucket window of control bytes
+                    (one cache line), then further windows in triangular order, so successive
+                    probes stay on one line and crowded regions are left quickly
+LinearProbing     - home, home + 1, home + 2, ...
+TriangularProbing - home + 1, home + 3, home + 6, ... (quadratic; still visits every bucket)
+GroupProbing      - Swiss-table style: a whole group of control bytes is compared against the key's tag
+                    and against ESS with a few SIMD instructions, groups are visited in triangular order
+RobinHoodProbing  - linear probing where an entry far from home takes the bucket of one closer to its
+                    own home, and remove() shifts the following entries back instead of leaving
+                    tombstones; control bytes hold each entry's distance from home and a shorter tag
+The bucket-at-a-time policies provide a Sequence over a power-of-two table; its first index is
+the home bucket and `mask + 1` consecutive next() calls visit every bucket exactly once.
+ */
+struct LinearProbing {
+    static constexpr bool GROUPED = false;
+    static constexpr bool ROBIN_HOOD = false;
+
+    class Sequence {
+    private:
+        size_t position;
+        size_t mask;
+
+    public:
+        Sequence(size_t home, size_t mask) : position(home), mask(mask) {}
+        size_t index() const { return position; }
+        void next() { position = (position + 1) & mask; }
+    };
+};
+
+struct TriangularProbing {
+    static constexpr bool GROUPED = false;
+    static constexpr bool ROBIN_HOOD = false;
+
+    class Sequence {
+    private:
+        size_t position;
+        size_t step = 0;
+        size_t mask;
+
+    public:
+        Sequence(size_t home, size_t mask) : position(home), mask(mask) {}
+        size_t index() const { return position; }
+        void next() { position = (position + ++step) & mask; }
+    };
+};
+
+struct RandomProbing {
+    static constexpr bool GROUPED = false;
+    static constexpr bool ROBIN_HOOD = false;
+    static constexpr size_t WINDOW = 64;  // Buckets per window: one cache line of control bytes
+
+    /*
+    Within a window the offsets from the home bucket follow x -> 5x + 1 (mod window size),
+    a full-period generator, so every bucket of the window is visited once in scrambled order.
+    The walk then jumps 1, 2, 3, ... windows ahead (triangular over windows, which reaches every
+    window) so that keys spilling out of a crowded window do not all land in the adjacent one
+     */
+    class Sequence {
+    private:
+        size_t base;        // First bucket of the current window
+        size_t start;       // Home bucket's position inside a window
+        size_t offset = 0;  // Current pseudo-random offset inside the window
+        size_t windows = 0; // Windows finished so far
+        size_t windowMask;  // Window size - 1 (the whole table if it is smaller than a window)
+        size_t mask;
+
+    public:
+        Sequence(size_t home, size_t mask)
+            : windowMask(mask < WINDOW - 1 ? mask : WINDOW - 1), mask(mask) {
+            base = home & ~windowMask;
+            start = home & windowMask;
+        }
+        size_t index() const { return base + ((start + offset) & windowMask); }
+        void next() {
+            offset = (offset * 5 + 1) & windowMask;
+            if (offset == 0) base = (base + ++windows * (windowMask + 1)) & mask;  // Window exhausted
+        }
+    };
+};
+
+namespace probe_detail {
+
+/*
+ControlGroup - one group of control bytes loaded into a register
+Each query returns a bitmask with bit i set when control byte i qualifies.
+Relies on the table's control byte encoding: NORMAL 0x00-0x7F, ESS 0x80, EAR 0xFE and
+0xFF for padding bytes past the last bucket (never matched by any query)
+ */
+struct ControlGroup {
+#if defined(HASHTABLE_PROBE_AVX2)
+    static constexpr size_t WIDTH = 32;
+    __m256i bytes;
+
+    explicit ControlGroup(const uint8_t* p)
+        : bytes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    // Bytes equal to `value` (a tag or ESS)
+    uint32_t match(uint8_t value) const {
+        __m256i target = _mm256_set1_epi8(static_cast<char>(value));
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, target)));
+    }
+
+    // ESS or EAR bytes: as signed chars they are the only values below -1 (0xFF)
+    uint32_t matchFree() const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(-1), bytes)));
+    }
+#elif defined(HASHTABLE_PROBE_SSE2)
+    static constexpr size_t WIDTH = 16;
+    __m128i bytes;
+
+    explicit ControlGroup(const uint8_t* p)
+        : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    uint32_t match(uint8_t value) const {
+        __m128i target = _mm_set1_epi8(static_cast<char>(value));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, target)));
+    }
+
+    uint32_t matchFree() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), bytes)));
+    }
+#else
+    static constexpr size_t WIDTH = 16;
+    uint8_t bytes[WIDTH];
+
+    explicit ControlGroup(const uint8_t* p) { std::memcpy(bytes, p, WIDTH); }
+
+    uint32_t match(uint8_t value) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; i++) mask |= static_cast<uint32_t>(bytes[i] == value) << i;
+        return mask;
+    }
+
+    uint32_t matchFree() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; i++) mask |= static_cast<uint32_t>(bytes[i] == 0x80 || bytes[i] == 0xFE) << i;
+        return mask;
+    }
+#endif
+};
+
+// Index of the lowest set bit, and the mask with that bit cleared (for walking match masks)
+inline size_t lowestBit(uint32_t mask) { return static_cast<size_t>(std::countr_zero(mask)); }
+inline uint32_t clearLowestBit(uint32_t mask) { return mask & (mask - 1); }
+
+// Ask the CPU to start loading the cache line holding `address`, for a probe a few keys ahead
+// (compiles to nothing where no prefetch instruction is available)
+inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(HASHTABLE_PROBE_AVX2) || defined(HASHTABLE_PROBE_SSE2)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+} // namespace probe_detail
+
+struct GroupProbing {
+    static constexpr bool GROUPED = true;
+    static constexpr bool ROBIN_HOOD = false;
+    static constexpr size_t GROUP_WIDTH = probe_detail::ControlGroup::WIDTH;  // 32 with AVX2, else 16
+};
+
+/*
+Robin Hood hashing over a linear walk. Entries along a run stay ordered by distance from home:
+an insert takes the first bucket whose entry is closer to its home than the new key is to its own,
+and pushes that entry and the rest of the run one bucket on. A lookup stops at the first entry
+closer to home than itself, so misses end early, and the longest walk stays short even at high
+load. remove() moves the rest of the run back one bucket, so the table never holds tombstones
+ */
+struct RobinHoodProbing {
+    static constexpr bool GROUPED = false;
+    static constexpr bool ROBIN_HOOD = true;
+    static constexpr size_t MAX_STORED_DISTANCE = 15;  // Larger distances are recomputed from the hash
+
+    using Sequence = LinearProbing::Sequence;  // Distance from home is the number of steps taken
+
+    // A NORMAL control byte holds the distance from home in bits 3-6 (saturating at MAX_STORED_DISTANCE)
+    // and a 3-bit tag from the hash in bits 0-2, so most entries sharing a home are told apart unread
+    static uint8_t control(size_t distance, size_t hash) {
+        return withDistance(static_cast<uint8_t>(hash & 0x7), distance);
+    }
+    static uint8_t withDistance(uint8_t control, size_t distance) {
+        size_t stored = distance < MAX_STORED_DISTANCE ? distance : MAX_STORED_DISTANCE;
+        return static_cast<uint8_t>((control & 0x7) | (stored << 3));
+    }
+    static size_t storedDistance(uint8_t control) { return control >> 3; }
+    static bool tagMatches(uint8_t control, size_t hash) { return (control & 0x7) == (hash & 0x7); }
+};
+
+#endif
@@ -0,0 +1,12 @@
+/*
+ShardedHashTable.cpp
+Sharded variant of the hash table: independent HashTable shards picked by the top bits of the
+key's hash, one lock each (see ShardedHashTable.h).
+ */
+
+#include "ShardedHashTable.h"
+
+// SHARDEDHASHTABLE TEMPLATE INSTANTIATION
+// The string -> int configuration is compiled once here;
+// ShardedHashTable.h marks it extern so other translation units reuse this code
+template class ShardedHashTable<string, int>;
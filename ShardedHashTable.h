@@ -0,0 +1,125 @@
+#ifndef SHARDEDHASHTABLE_H
+#define SHARDEDHASHTABLE_H
+
+#include <concepts> // For std::equality_comparable (comparing hash policies)
+#include <memory>   // For std::unique_ptr (the shard array)
+#include <mutex>    // For std::mutex and std::scoped_lock (one lock per shard)
+
+#include "HashTable.h"  // The shards are ordinary BasicHashTables
+
+using namespace std;
+
+// ============================================================================
+// SHARDEDHASHTABLE CLASS - INDEPENDENT HASHTABLE SHARDS, ONE LOCK EACH
+// ============================================================================
+/*
+N independent BasicHashTables (N a power of two). A key lives in the shard picked by the top
+log2(N) bits of its hash, so:
+- Every operation locks only its key's shard; each shard and its lock sit on their own cache lines,
+  and with several shards per core two threads rarely meet on one
+- Each shard resizes on its own, holding only its own lock: a resize never stalls the other shards,
+  and it only has to move 1/N of the entries
+- Whole-table views (size(), alpha(), capacity(), keys()) visit the shards one after the other, each
+  under its lock, so they are exact once writers are done but not a snapshot while they run
+- for_each_shard(), for_each() and merge() hand the shards to worker threads, one shard at a time
+
+Like ConcurrentHashTable it returns copies, never references; upsert(key, fn) is the shared-table
+form of `ht[key] op ...` (it calls fn on table[key] under the shard's lock)
+ */
+
+template<typename K = string,
+         typename V = int,
+         typename Hash = DefaultHash<K>,
+         typename KeyEqual = equal_to<>,
+         typename Alloc = allocator<pair<const K, V>>,
+         typename Probe = RandomProbing>
+class ShardedHashTable {
+public:
+    // TYPE DEFINITIONS
+    using key_type = K;
+    using mapped_type = V;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+    using Table = BasicHashTable<K, V, Hash, KeyEqual, Alloc, Probe>;  // One shard
+
+private:
+    static constexpr bool TRANSPARENT =
+        table_detail::IS_TRANSPARENT<Hash> && table_detail::IS_TRANSPARENT<KeyEqual>;
+
+    template<typename L>
+    using key_arg = typename table_detail::KeyArg<TRANSPARENT>::template type<L, K>;
+
+    // One shard, on its own cache lines so that shards never share a line
+    struct alignas(64) Shard {
+        mutable mutex lock;
+        Table table;
+    };
+
+    // PRIVATE MEMBER VARIABLES
+    unique_ptr<Shard[]> shards;  // The shards
+    size_t shardTotal;           // Number of shards (a power of two)
+    unsigned shardShift;         // 64 - log2(shardTotal): hash >> shardShift is the shard index
+    Hash hashPolicy;             // Hash policy instance (each shard holds its own copy too)
+
+    // PRIVATE HELPER METHODS
+    template<typename KeyLike>
+    Shard& shardFor(const KeyLike& key) const;  // Shard holding a key (top bits of its hash)
+    template<typename Fn>
+    void parallelShards(Fn fn) const;           // Run fn(shard index) for every shard on worker threads
+    bool sameSharding(const ShardedHashTable& other) const;  // Does other put every key in the same shard index
+
+public:
+    // PUBLIC CONSTANTS
+    static constexpr size_t SHARDS_PER_THREAD = 4;  // Default shard count per hardware thread
+
+    // CONSTRUCTOR
+    // shardCount is rounded up to a power of two; 0 picks SHARDS_PER_THREAD per hardware thread.
+    // initCapacity is the initial capacity of each shard. Not copyable or movable
+    explicit ShardedHashTable(size_t shardCount = 0, size_t initCapacity = Table::DEFAULT_INITIAL_CAPACITY,
+                              const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                              const Alloc& alloc = Alloc());
+    ShardedHashTable(const ShardedHashTable&) = delete;
+    ShardedHashTable& operator=(const ShardedHashTable&) = delete;
+
+    // MAP OPERATIONS - all of them may be called from any number of threads at once
+    bool insert(K key, V value);                  // Insert key-value pair (no duplicates)
+    bool insert_or_assign(K key, V value);        // Insert, or overwrite the stored value; true if inserted
+    template<typename KeyArg = K, typename Fn>
+    void upsert(const key_arg<KeyArg>& key, Fn fn);     // Call fn(V&) on table[key] (default V if new) under the lock
+    template<typename KeyArg = K, typename Fn>
+    bool update(const key_arg<KeyArg>& key, Fn fn);     // Call fn(V&) on the stored value; false if missing
+    template<typename KeyArg = K>
+    bool remove(const key_arg<KeyArg>& key);      // Remove key-value pair
+    template<typename KeyArg = K>
+    bool contains(const key_arg<KeyArg>& key) const;    // Check if key exists
+    template<typename KeyArg = K>
+    optional<V> get(const key_arg<KeyArg>& key) const;  // Copy of the value for key
+
+    // UTILITY METHODS - aggregated over the shards
+    vector<K> keys() const;       // All keys, shard by shard
+    double alpha() const;         // Entries per bucket over all shards
+    size_t capacity() const;      // Total number of buckets
+    size_t size() const;          // Number of key-value pairs
+    size_t shardCount() const;    // Number of shards
+    void max_load_factor(double load);  // Set every shard's resize threshold (throws invalid_argument like HashTable)
+    void reserve(size_t count);         // Size every shard for its share of count evenly spread entries
+
+    // PARALLEL OPERATIONS
+    // The shards are handed out to min(shardCount(), hardware threads) workers; each shard is locked
+    // while it is being visited, so fn runs concurrently for different shards and must be thread-safe
+    template<typename Fn>
+    void for_each_shard(Fn fn);         // fn(size_t index, Table& shard) for every shard
+    template<typename Fn>
+    void for_each(Fn fn) const;         // fn(const K&, const V&) for every entry
+    template<typename Combine>
+    void merge(const ShardedHashTable& other, Combine combine);  // Add other's entries; combine(V& mine, const V& theirs) on clashes
+};
+
+// Template member definitions
+#include "ShardedHashTable.tpp"
+
+// The default configuration is compiled once, in ShardedHashTable.cpp
+extern template class ShardedHashTable<string, int>;
+
+#endif
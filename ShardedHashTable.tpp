@@ -0,0 +1,322 @@
+/* ShardedHashTable.tpp
+Template member definitions for ShardedHashTable, included at the bottom of ShardedHashTable.h.
+ */
+
+#ifndef SHARDEDHASHTABLE_TPP
+#define SHARDEDHASHTABLE_TPP
+
+#include <atomic>     // For the shard counter the workers share
+#include <exception>  // For std::exception_ptr (rethrowing a worker's exception)
+#include <thread>     // For std::thread (parallel operations)
+
+// Shorthands for the template headers of out-of-line member definitions
+#define SHT_TEMPLATE template<typename K, typename V, typename Hash, typename KeyEqual, typename Alloc, typename Probe>
+#define SHT_CLASS ShardedHashTable<K, V, Hash, KeyEqual, Alloc, Probe>
+
+/*
+Constructor - shardCount shards (a power of two) of initCapacity buckets each
+ */
+SHT_TEMPLATE
+SHT_CLASS::ShardedHashTable(size_t shardCount, size_t initCapacity, const Hash& hash,
+                            const KeyEqual& equal, const Alloc& alloc)
+    : hashPolicy(hash) {
+    if (shardCount == 0) shardCount = SHARDS_PER_THREAD * std::max(1u, thread::hardware_concurrency());
+    shardTotal = std::bit_ceil(shardCount);
+    shardShift = 64 - static_cast<unsigned>(std::countr_zero(shardTotal));
+    shards.reset(new Shard[shardTotal]);
+    for (size_t i = 0; i < shardTotal; i++) shards[i].table = Table(initCapacity, hash, equal, alloc);
+}
+
+// PRIVATE HELPER METHODS
+
+/*The shard holding a key: the top bits of its hash
+(each shard's own home index is taken from the same hash multiplied out, so the bits shared by a
+shard's keys do not crowd its buckets)
+ */
+SHT_TEMPLATE
+template<typename KeyLike>
+typename SHT_CLASS::Shard& SHT_CLASS::shardFor(const KeyLike& key) const {
+    uint64_t hash = static_cast<uint64_t>(hashPolicy(key));
+    return shards[shardTotal == 1 ? 0 : static_cast<size_t>(hash >> shardShift)];
+}
+
+/*Run fn(index) once for every shard index on min(shards, hardware threads) worker threads,
+which take the next unvisited shard until none are left. The first exception thrown by fn is
+rethrown here once every worker has stopped
+ */
+SHT_TEMPLATE
+template<typename Fn>
+void SHT_CLASS::parallelShards(Fn fn) const {
+    size_t workerCount = std::min<size_t>(shardTotal, std::max(1u, thread::hardware_concurrency()));
+    if (workerCount == 1) {
+        for (size_t i = 0; i < shardTotal; i++) fn(i);
+        return;
+    }
+
+    atomic<size_t> next{0};
+    exception_ptr failure;
+    mutex failureLock;
+    auto work = [&] {
+        try {
+            for (size_t i = next++; i < shardTotal; i = next++) fn(i);
+        } catch (...) {
+            lock_guard<mutex> guard(failureLock);
+            if (!failure) failure = current_exception();
+            next = shardTotal;  // Stop the other workers early
+        }
+    };
+    vector<thread> workers;
+    for (size_t w = 1; w < workerCount; w++) workers.emplace_back(work);
+    work();  // The calling thread is a worker too
+    for (thread& worker : workers) worker.join();
+    if (failure) rethrow_exception(failure);
+}
+
+/*Whether other sends every key to the same shard index as this table: the same shard count and a
+hash policy that hashes alike - a stateless one, or one that compares equal (e.g. WyHash with the
+same seed). A policy that cannot be compared counts as different
+ */
+SHT_TEMPLATE
+bool SHT_CLASS::sameSharding(const ShardedHashTable& other) const {
+    if (other.shardTotal != shardTotal) return false;
+    if constexpr (is_empty_v<Hash>) {
+        return true;
+    } else if constexpr (equality_comparable<Hash>) {
+        return hashPolicy == other.hashPolicy;
+    } else {
+        return false;
+    }
+}
+
+// MAP OPERATIONS
+
+/*Insert a key-value pair into its shard
+@return: true if inserted successfully, false if key already exists
+ */
+SHT_TEMPLATE
+bool SHT_CLASS::insert(K key, V value) {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    return shard.table.insert(std::move(key), std::move(value));
+}
+
+/*Insert a key-value pair, or overwrite the value of a key already stored
+@return: true if the key was inserted, false if its value was assigned
+ */
+SHT_TEMPLATE
+bool SHT_CLASS::insert_or_assign(K key, V value) {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    return shard.table.insert_or_assign(key, std::move(value));
+}
+
+/*Call fn(V&) on the value of key, inserting a default V first if the key is new -
+the shared-table form of `ht[key]++`: upsert(key, [](int& count) { count++; })
+fn runs with the shard locked, so it must be short and must not call back into the table.
+With a transparent hash the key may be a string_view: a K is built only when the key is new
+ */
+SHT_TEMPLATE
+template<typename KeyArg, typename Fn>
+void SHT_CLASS::upsert(const key_arg<KeyArg>& key, Fn fn) {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    fn(shard.table.template operator[]<KeyArg>(key));
+}
+
+/*Call fn(V&) on the stored value of key, under the shard's lock
+@return: true if the key was found and fn was called
+ */
+SHT_TEMPLATE
+template<typename KeyArg, typename Fn>
+bool SHT_CLASS::update(const key_arg<KeyArg>& key, Fn fn) {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    V* stored = shard.table.template find<KeyArg>(key);
+    if (!stored) return false;
+    fn(*stored);
+    return true;
+}
+
+/*Remove a key-value pair (only its shard may shrink)
+@return: true if removed successfully, false if key not found
+ */
+SHT_TEMPLATE
+template<typename KeyArg>
+bool SHT_CLASS::remove(const key_arg<KeyArg>& key) {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    return shard.table.template remove<KeyArg>(key);
+}
+
+//Check if a key exists
+
+SHT_TEMPLATE
+template<typename KeyArg>
+bool SHT_CLASS::contains(const key_arg<KeyArg>& key) const {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    return shard.table.template contains<KeyArg>(key);
+}
+
+//Get a copy of the value for a key
+
+SHT_TEMPLATE
+template<typename KeyArg>
+optional<V> SHT_CLASS::get(const key_arg<KeyArg>& key) const {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> guard(shard.lock);
+    return shard.table.template get<KeyArg>(key);
+}
+
+// UTILITY METHODS
+
+//All keys, collected one shard at a time
+
+SHT_TEMPLATE
+vector<K> SHT_CLASS::keys() const {
+    vector<K> result;
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        shards[i].table.for_each([&](const K& key, const V&) { result.push_back(key); });
+    }
+    return result;
+}
+
+//Load factor over all shards: entries per bucket
+
+SHT_TEMPLATE
+double SHT_CLASS::alpha() const {
+    size_t items = 0;
+    size_t buckets = 0;
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        items += shards[i].table.size();
+        buckets += shards[i].table.capacity();
+    }
+    return buckets == 0 ? 0.0 : static_cast<double>(items) / static_cast<double>(buckets);
+}
+
+//Total number of buckets
+
+SHT_TEMPLATE
+size_t SHT_CLASS::capacity() const {
+    size_t total = 0;
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        total += shards[i].table.capacity();
+    }
+    return total;
+}
+
+//Number of entries: the sum of the shard sizes
+
+SHT_TEMPLATE
+size_t SHT_CLASS::size() const {
+    size_t total = 0;
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        total += shards[i].table.size();
+    }
+    return total;
+}
+
+//Number of shards
+
+SHT_TEMPLATE
+size_t SHT_CLASS::shardCount() const {
+    return shardTotal;
+}
+
+/*Set the resize threshold of every shard
+@throws invalid_argument outside (0, MAX_MAX_LOAD_FACTOR], before any shard is changed
+ */
+SHT_TEMPLATE
+void SHT_CLASS::max_load_factor(double load) {
+    if (!(load > 0.0 && load <= Table::MAX_MAX_LOAD_FACTOR)) {
+        throw invalid_argument("max_load_factor must be in (0, 0.95]");
+    }
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        shards[i].table.max_load_factor(load);
+    }
+}
+
+//Reserve room in every shard for its share of `count` entries (keys spread evenly over the shards)
+
+SHT_TEMPLATE
+void SHT_CLASS::reserve(size_t count) {
+    size_t perShard = (count + shardTotal - 1) / shardTotal;
+    for (size_t i = 0; i < shardTotal; i++) {
+        lock_guard<mutex> guard(shards[i].lock);
+        shards[i].table.reserve(perShard);
+    }
+}
+
+// PARALLEL OPERATIONS
+
+//Call fn(index, shard) for every shard, shards in parallel, each locked while fn runs
+
+SHT_TEMPLATE
+template<typename Fn>
+void SHT_CLASS::for_each_shard(Fn fn) {
+    parallelShards([&](size_t i) {
+        lock_guard<mutex> guard(shards[i].lock);
+        fn(i, shards[i].table);
+    });
+}
+
+//Call fn(key, value) for every entry, shards in parallel, each locked while it is visited
+
+SHT_TEMPLATE
+template<typename Fn>
+void SHT_CLASS::for_each(Fn fn) const {
+    parallelShards([&](size_t i) {
+        lock_guard<mutex> guard(shards[i].lock);
+        shards[i].table.for_each(fn);
+    });
+}
+
+/*Add every entry of `other` to this table; for a key in both, combine(V& mine, const V& theirs)
+decides the result (e.g. adding per-thread counters into a total)
+When other shards keys the same way (sameSharding()), shard i of other only holds keys of shard i
+here, so the shard pairs merge in parallel, both locked. Otherwise (another shard count, or a hash
+with another seed) each shard of other is copied out under its own lock and every entry is routed
+through shardFor() here
+@throws invalid_argument when merging a table into itself
+ */
+SHT_TEMPLATE
+template<typename Combine>
+void SHT_CLASS::merge(const ShardedHashTable& other, Combine combine) {
+    if (&other == this) throw invalid_argument("merge: cannot merge a table into itself");
+
+    auto add = [&](Table& target, const K& key, const V& value) {
+        auto [stored, inserted] = target.try_emplace(key, value);
+        if (!inserted) combine(*stored, value);
+    };
+
+    if (sameSharding(other)) {
+        parallelShards([&](size_t i) {
+            scoped_lock guard(shards[i].lock, other.shards[i].lock);
+            other.shards[i].table.for_each([&](const K& key, const V& value) { add(shards[i].table, key, value); });
+        });
+        return;
+    }
+
+    other.parallelShards([&](size_t i) {
+        vector<pair<K, V>> entries;
+        {
+            lock_guard<mutex> guard(other.shards[i].lock);
+            other.shards[i].table.for_each([&](const K& key, const V& value) { entries.emplace_back(key, value); });
+        }
+        for (const auto& [key, value] : entries) {
+            Shard& shard = shardFor(key);
+            lock_guard<mutex> guard(shard.lock);
+            add(shard.table, key, value);
+        }
+    });
+}
+
+#undef SHT_TEMPLATE
+#undef SHT_CLASS
+
+#endif